@@ -0,0 +1,536 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * octdata_bench: generates synthetic files for the formats with a simple layout
+ * and measures open latency, throughput and peak memory per reader and read option set.
+ * Every measurement runs in a forked process, so the peak RSS belongs to this single open call.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#include <boost/log/core.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/log/expressions.hpp>
+
+#include <opencv2/opencv.hpp>
+
+#include <octfileread.h>
+#include <filereadoptions.h>
+#include <datastruct/oct.h>
+#include <datastruct/bscan.h>
+#include <datastruct/octmetadata.h>
+
+#include <imgproc/lut16to8.h>
+#include <imgproc/bordercols.h>
+#include <imgproc/columnshift.h>
+
+#include "syntheticfiles.h"
+
+namespace bfs = std::filesystem;
+
+namespace
+{
+	struct BenchCase
+	{
+		std::string               name;
+		OctData::FileReadOptions  options;
+		bool                      metadataOnly = false;
+	};
+
+	struct RunResult
+	{
+		bool        ok         = false;
+		double      openSec    = 0;     // openFile / scanMetadata
+		double      accessSec  = 0;     // getImage of all B-scans (loads lazy B-scans)
+		std::size_t numBScans  = 0;
+		long        rssStartKB = 0;     // RSS of the forked process before the open call
+	};
+
+	struct CaseResult
+	{
+		std::string format;
+		std::string caseName;
+		double      fileMB      = 0;
+		double      openSec     = 0;    // median
+		double      totalSec    = 0;    // median of open + access
+		std::size_t numBScans   = 0;
+		long        peakRssKB   = 0;
+		long        rssDeltaKB  = 0;
+		int         failedRuns  = 0;
+	};
+
+	struct BenchConfig
+	{
+		OctDataBench::SyntheticSize size;
+		bfs::path                   dir       = bfs::temp_directory_path() / "octdata_bench";
+		int                         repeat    = 3;
+		bool                        keepFiles = false;
+		bool                        csv       = false;
+		bool                        verbose   = false;
+		bool                        kernels   = false;
+		std::vector<std::string>    formats;
+		std::vector<std::string>    caseNames;
+		std::vector<bfs::path>      extraFiles;
+	};
+
+
+	std::vector<BenchCase> getBenchCases()
+	{
+		std::vector<BenchCase> cases;
+
+		cases.push_back(BenchCase{"default", OctData::FileReadOptions()});
+
+		BenchCase singleThread{"singleThread", OctData::FileReadOptions()};
+		singleThread.options.numThreads = 1;
+		cases.push_back(singleThread);
+
+		BenchCase lazy{"lazy", OctData::FileReadOptions()};
+		lazy.options.lazyBScans = true;
+		cases.push_back(lazy);
+
+		BenchCase rawData{"rawData", OctData::FileReadOptions()};
+		rawData.options.holdRawData = true;
+		cases.push_back(rawData);
+
+		BenchCase noSlo{"noSlo", OctData::FileReadOptions()};
+		noSlo.options.readSlo = false;
+		cases.push_back(noSlo);
+
+		BenchCase noBScans{"noBScans", OctData::FileReadOptions()};
+		noBScans.options.readBScans = false;
+		cases.push_back(noBScans);
+
+		BenchCase metadata{"metadata", OctData::FileReadOptions()};
+		metadata.metadataOnly = true;
+		cases.push_back(metadata);
+
+		return cases;
+	}
+
+	std::vector<std::string> splitList(const std::string& str)
+	{
+		std::vector<std::string> elements;
+		std::stringstream stream(str);
+		std::string element;
+		while(std::getline(stream, element, ','))
+			if(!element.empty())
+				elements.push_back(element);
+		return elements;
+	}
+
+	long currentMaxRssKB()
+	{
+		rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+		return usage.ru_maxrss;
+	}
+
+	double secondsSince(const std::chrono::steady_clock::time_point& start)
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	std::size_t touchAllBScans(const OctData::OCT& oct)
+	{
+		std::size_t numBScans = 0;
+		for(const OctData::OCT::SubstructurePair& patPair : oct)
+			for(const OctData::Patient::SubstructurePair& studyPair : *patPair.second)
+				for(const OctData::Study::SubstructurePair& seriesPair : *studyPair.second)
+				{
+					const OctData::Series& series = *seriesPair.second;
+					for(std::size_t i = 0; i < series.bscanCount(); ++i)
+					{
+						const std::shared_ptr<const OctData::BScan> bscan = series.getBScan(i);
+						if(bscan && !bscan->getImage().empty())
+							++numBScans;
+					}
+				}
+		return numBScans;
+	}
+
+	RunResult runCase(const bfs::path& file, const BenchCase& benchCase)
+	{
+		RunResult result;
+		result.rssStartKB = currentMaxRssKB();
+
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		if(benchCase.metadataOnly)
+		{
+			const OctData::OctMetadata metadata = OctData::OctFileRead::scanMetadata(file, benchCase.options);
+			result.openSec = secondsSince(start);
+			result.ok      = !metadata.empty();
+			for(const OctData::SeriesMetadata& series : metadata.getSeries())
+				result.numBScans += series.numBScans;
+			return result;
+		}
+
+		const OctData::OCT oct = OctData::OctFileRead::openFile(file, benchCase.options);
+		result.openSec = secondsSince(start);
+
+		result.numBScans = touchAllBScans(oct);
+		result.accessSec = secondsSince(start) - result.openSec;
+		result.ok        = oct.size() > 0;
+		return result;
+	}
+
+	// runs the case in a child process, returns the peak RSS of the child in rusage
+	bool runCaseForked(const bfs::path& file, const BenchCase& benchCase, bool verbose, RunResult& result, long& peakRssKB)
+	{
+		int fds[2];
+		if(pipe(fds) != 0)
+			return false;
+
+		const pid_t pid = fork();
+		if(pid < 0)
+		{
+			close(fds[0]);
+			close(fds[1]);
+			return false;
+		}
+
+		if(pid == 0)
+		{
+			close(fds[0]);
+			if(!verbose) // some readers print the file header
+			{
+				const int devNull = open("/dev/null", O_WRONLY);
+				if(devNull >= 0)
+				{
+					dup2(devNull, STDOUT_FILENO);
+					close(devNull);
+				}
+			}
+
+			RunResult childResult;
+			try
+			{
+				childResult = runCase(file, benchCase);
+			}
+			catch(const std::exception& e)
+			{
+				std::cerr << file << ": " << e.what() << std::endl;
+			}
+			const ssize_t written = write(fds[1], &childResult, sizeof(childResult));
+			close(fds[1]);
+			_exit(written == sizeof(childResult) ? 0 : 1);
+		}
+
+		close(fds[1]);
+		const ssize_t readBytes = read(fds[0], &result, sizeof(result));
+		close(fds[0]);
+
+		int    status = 0;
+		rusage usage;
+		wait4(pid, &status, 0, &usage);
+		peakRssKB = usage.ru_maxrss;
+
+		return readBytes == sizeof(result) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+	}
+
+	double median(std::vector<double> values)
+	{
+		if(values.empty())
+			return 0;
+		std::sort(values.begin(), values.end());
+		return values[values.size()/2];
+	}
+
+	CaseResult benchFile(const std::string& format, const bfs::path& file, const BenchCase& benchCase, const BenchConfig& config)
+	{
+		CaseResult caseResult;
+		caseResult.format   = format;
+		caseResult.caseName = benchCase.name;
+		caseResult.fileMB   = static_cast<double>(bfs::file_size(file))/(1024.*1024.);
+
+		std::vector<double> openTimes;
+		std::vector<double> totalTimes;
+		for(int run = 0; run < config.repeat; ++run)
+		{
+			RunResult result;
+			long      peakRssKB = 0;
+			if(!runCaseForked(file, benchCase, config.verbose, result, peakRssKB) || !result.ok)
+			{
+				++caseResult.failedRuns;
+				continue;
+			}
+
+			openTimes .push_back(result.openSec);
+			totalTimes.push_back(result.openSec + result.accessSec);
+			caseResult.numBScans  = result.numBScans;
+			caseResult.peakRssKB  = std::max(caseResult.peakRssKB , peakRssKB);
+			caseResult.rssDeltaKB = std::max(caseResult.rssDeltaKB, peakRssKB - result.rssStartKB);
+		}
+
+		caseResult.openSec  = median(openTimes);
+		caseResult.totalSec = median(totalTimes);
+		return caseResult;
+	}
+
+	void printResults(const std::vector<CaseResult>& results, bool csv)
+	{
+		if(csv)
+		{
+			std::cout << "format,options,file_mb,open_ms,total_ms,mb_per_s,bscans,bscans_per_s,peak_rss_mb,rss_delta_mb,failed_runs\n";
+			for(const CaseResult& r : results)
+			{
+				const double mbPerSec     = r.totalSec > 0 ? r.fileMB/r.totalSec : 0;
+				const double bscansPerSec = r.totalSec > 0 ? static_cast<double>(r.numBScans)/r.totalSec : 0;
+				std::cout << r.format << ',' << r.caseName << ',' << r.fileMB << ','
+				          << r.openSec*1000 << ',' << r.totalSec*1000 << ',' << mbPerSec << ','
+				          << r.numBScans << ',' << bscansPerSec << ','
+				          << static_cast<double>(r.peakRssKB)/1024. << ',' << static_cast<double>(r.rssDeltaKB)/1024. << ','
+				          << r.failedRuns << '\n';
+			}
+			std::cout << std::flush;
+			return;
+		}
+
+		std::cout << std::left  << std::setw(10) << "format"
+		                        << std::setw(14) << "options"
+		          << std::right << std::setw(10) << "file MB"
+		                        << std::setw(11) << "open ms"
+		                        << std::setw(11) << "total ms"
+		                        << std::setw(10) << "MB/s"
+		                        << std::setw( 8) << "B-scans"
+		                        << std::setw(11) << "B-scans/s"
+		                        << std::setw(10) << "RSS MB"
+		                        << std::setw(10) << "+RSS MB"
+		                        << '\n';
+
+		std::cout << std::fixed << std::setprecision(1);
+		for(const CaseResult& r : results)
+		{
+			std::cout << std::left << std::setw(10) << r.format << std::setw(14) << r.caseName << std::right;
+			if(r.failedRuns > 0 && r.totalSec == 0)
+			{
+				std::cout << std::setw(10) << r.fileMB << "   failed" << '\n';
+				continue;
+			}
+
+			const double mbPerSec     = r.totalSec > 0 ? r.fileMB/r.totalSec : 0;
+			const double bscansPerSec = r.totalSec > 0 ? static_cast<double>(r.numBScans)/r.totalSec : 0;
+			std::cout << std::setw(10) << r.fileMB
+			          << std::setw(11) << r.openSec*1000
+			          << std::setw(11) << r.totalSec*1000
+			          << std::setw(10) << mbPerSec
+			          << std::setw( 8) << r.numBScans
+			          << std::setw(11) << bscansPerSec
+			          << std::setw(10) << static_cast<double>(r.peakRssKB )/1024.
+			          << std::setw(10) << static_cast<double>(r.rssDeltaKB)/1024.
+			          << '\n';
+		}
+		std::cout << std::flush;
+	}
+
+	// image kernels of the B-scan conversion, synthetic B-scans with the typical Spectralis sizes
+	void benchKernels(const BenchConfig& config)
+	{
+		const int              rows       = 496;
+		const std::vector<int> widths     = {512, 768, 1024, 1536};
+		const int              iterations = 200;
+
+		// 0 is "no data" and white after the transform (like the E2E gray transforms)
+		std::vector<uint8_t> lut(OctData::lut16To8TableSize, 0);
+		for(std::size_t i = 1; i < lut.size(); ++i)
+			lut[i] = static_cast<uint8_t>(std::min<std::size_t>(i >> 8, 254));
+		lut[0] = 255;
+
+		OctData::ColumnShift shift;
+		shift.shiftX  = 3;
+		shift.slopeY  = 0.02;
+		shift.offsetY = -5.5;
+
+		struct Kernel
+		{
+			std::string                                   name;
+			std::function<void(const cv::Mat&, cv::Mat&)> run;
+		};
+		const std::vector<Kernel> kernels =
+		{
+			{"lut16To8"              , [&](const cv::Mat& src, cv::Mat& dest) { OctData::lut16To8(src, dest, lut.data()); }},
+			{"lut16To8+fillBorder"   , [&](const cv::Mat& src, cv::Mat& dest) { OctData::lut16To8(src, dest, lut.data()); OctData::fillEmptyBorderCols(dest, 255, 0); }},
+			{"lut16To8FillBorderCols", [&](const cv::Mat& src, cv::Mat& dest) { OctData::lut16To8FillBorderCols(src, dest, lut.data(), 255, 0); }},
+			{"columnShift"           , [&](const cv::Mat& src, cv::Mat& dest) { cv::Mat image; OctData::lut16To8(src, image, lut.data()); OctData::columnShift(image, dest, shift, 0, true); }},
+		};
+
+		if(config.csv)
+			std::cout << "kernel,rows,cols,us_per_bscan,mpixel_per_s\n";
+		else
+			std::cout << std::left  << std::setw(24) << "kernel"
+			          << std::right << std::setw(11) << "size"
+			                        << std::setw(12) << "us/B-scan"
+			                        << std::setw(12) << "MPixel/s"
+			          << '\n' << std::fixed << std::setprecision(1);
+
+		for(int cols : widths)
+		{
+			cv::Mat src(rows, cols, cv::DataType<uint16_t>::type);
+			cv::randu(src, cv::Scalar(1), cv::Scalar(65535));
+			const int borderCols = cols/16;
+			src.colRange(0, borderCols).setTo(cv::Scalar(0));
+			src.colRange(cols - borderCols, cols).setTo(cv::Scalar(0));
+
+			for(const Kernel& kernel : kernels)
+			{
+				cv::Mat dest;
+				kernel.run(src, dest); // warm up, allocation of dest
+
+				std::vector<double> times;
+				for(int run = 0; run < config.repeat; ++run)
+				{
+					const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+					for(int i = 0; i < iterations; ++i)
+						kernel.run(src, dest);
+					times.push_back(secondsSince(start)/iterations);
+				}
+
+				const double sec          = median(times);
+				const double mpixelPerSec = sec > 0 ? static_cast<double>(rows*cols)/sec/1e6 : 0;
+				if(config.csv)
+					std::cout << kernel.name << ',' << rows << ',' << cols << ',' << sec*1e6 << ',' << mpixelPerSec << '\n';
+				else
+					std::cout << std::left  << std::setw(24) << kernel.name
+					          << std::right << std::setw(11) << (std::to_string(rows) + "x" + std::to_string(cols))
+					                        << std::setw(12) << sec*1e6
+					                        << std::setw(12) << mpixelPerSec
+					          << '\n';
+			}
+		}
+		std::cout << std::flush;
+	}
+
+	void printUsage(const char* programName)
+	{
+		std::cout << "usage: " << programName << " [options]\n"
+		          << "  --dir <path>       directory for the synthetic files\n"
+		          << "  --bscans <n>       number of B-scans\n"
+		          << "  --width <n>        A-scans per B-scan\n"
+		          << "  --height <n>       pixel per A-scan\n"
+		          << "  --slo <n>          size of the SLO image\n"
+		          << "  --repeat <n>       runs per reader and option set (median is reported)\n"
+		          << "  --formats <list>   comma separated, available:";
+		for(const std::string& format : OctDataBench::syntheticFormats())
+			std::cout << ' ' << format;
+		std::cout << "\n  --options <list>   comma separated read option sets, available:";
+		for(const BenchCase& benchCase : getBenchCases())
+			std::cout << ' ' << benchCase.name;
+		std::cout << "\n  --file <path>      additional existing file (any supported format)\n"
+		          << "  --keep             don't remove the synthetic files\n"
+		          << "  --csv              csv output\n"
+		          << "  --verbose          library log and reader output\n"
+		          << "  --kernels          image kernels of the B-scan conversion instead of the readers\n"
+		          << std::flush;
+	}
+
+	bool parseArguments(int argc, char** argv, BenchConfig& config)
+	{
+		for(int i = 1; i < argc; ++i)
+		{
+			const std::string arg = argv[i];
+			const bool hasValue = i+1 < argc;
+
+			if     (arg == "--dir"     && hasValue) config.dir                  = argv[++i];
+			else if(arg == "--bscans"  && hasValue) config.size.numBScans       = std::stoi(argv[++i]);
+			else if(arg == "--width"   && hasValue) config.size.bscanWidth      = std::stoi(argv[++i]);
+			else if(arg == "--height"  && hasValue) config.size.bscanHeight     = std::stoi(argv[++i]);
+			else if(arg == "--slo"     && hasValue) config.size.sloSize         = std::stoi(argv[++i]);
+			else if(arg == "--repeat"  && hasValue) config.repeat               = std::max(1, std::stoi(argv[++i]));
+			else if(arg == "--formats" && hasValue) config.formats              = splitList(argv[++i]);
+			else if(arg == "--options" && hasValue) config.caseNames            = splitList(argv[++i]);
+			else if(arg == "--file"    && hasValue) config.extraFiles.push_back(argv[++i]);
+			else if(arg == "--keep"               ) config.keepFiles            = true;
+			else if(arg == "--csv"                ) config.csv                  = true;
+			else if(arg == "--verbose"            ) config.verbose              = true;
+			else if(arg == "--kernels"            ) config.kernels              = true;
+			else
+				return false;
+		}
+		return config.size.numBScans > 0 && config.size.bscanWidth > 0 && config.size.bscanHeight > 0 && config.size.sloSize > 0;
+	}
+}
+
+
+int main(int argc, char** argv)
+{
+	BenchConfig config;
+	if(!parseArguments(argc, argv, config))
+	{
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	if(!config.verbose)
+		boost::log::core::get()->set_filter(boost::log::trivial::severity >= boost::log::trivial::warning);
+
+	if(config.kernels)
+	{
+		benchKernels(config);
+		return 0;
+	}
+
+	std::vector<BenchCase> cases;
+	for(const BenchCase& benchCase : getBenchCases())
+		if(config.caseNames.empty() || std::find(config.caseNames.begin(), config.caseNames.end(), benchCase.name) != config.caseNames.end())
+			cases.push_back(benchCase);
+
+	std::vector<OctDataBench::SyntheticFile> files;
+	if(config.extraFiles.empty() || !config.formats.empty())
+	{
+		std::cerr << "generate synthetic files in " << config.dir << " ("
+		          << config.size.numBScans << " B-scans " << config.size.bscanWidth << "x" << config.size.bscanHeight << ")" << std::endl;
+		files = OctDataBench::generateSyntheticFiles(config.dir, config.size, config.formats);
+	}
+
+	const std::size_t numGenerated = files.size();
+	for(const bfs::path& file : config.extraFiles)
+		files.push_back(OctDataBench::SyntheticFile{file.extension().generic_string(), file});
+
+	std::vector<CaseResult> results;
+	for(const OctDataBench::SyntheticFile& file : files)
+	{
+		for(const BenchCase& benchCase : cases)
+		{
+			std::cerr << "bench " << file.format << " / " << benchCase.name << std::endl;
+			results.push_back(benchFile(file.format, file.path, benchCase, config));
+		}
+	}
+
+	printResults(results, config.csv);
+
+	if(!config.keepFiles)
+	{
+		for(std::size_t i = 0; i < numGenerated; ++i)
+			bfs::remove(files[i].path);
+	}
+
+	return 0;
+}
@@ -0,0 +1,380 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "syntheticfiles.h"
+
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <memory>
+#include <algorithm>
+
+#include <opencv2/opencv.hpp>
+
+#ifdef TIFFSTACK_SUPPORT
+	#include <tiffio.h>
+#endif
+
+#include <octdata_packhelper.h>
+#include <octfileread.h>
+#include <filewriteoptions.h>
+#include <datastruct/oct.h>
+#include <datastruct/bscan.h>
+#include <datastruct/sloimage.h>
+
+
+namespace bfs = std::filesystem;
+
+namespace OctDataBench
+{
+	namespace
+	{
+		// same layout as in import/he_vol/volread.cpp
+		PACKSTRUCT(struct VolFileHeader
+		{
+			char     magic       [ 8];
+			char     version     [ 4];
+			uint32_t sizeX           ;
+			uint32_t numBScans       ;
+			uint32_t sizeZ           ;
+			double   scaleX          ;
+			double   distance        ;
+			double   scaleZ          ;
+			uint32_t sizeXSlo        ;
+			uint32_t sizeYSlo        ;
+			double   scaleXSlo       ;
+			double   scaleYSlo       ;
+			uint32_t fieldSizeSlo    ;
+			double   scanFocus       ;
+			char     scanPosition[ 4];
+			uint64_t examTime        ;
+			uint32_t scanPattern     ;
+			uint32_t bScanHdrSize    ;
+			char     id          [16];
+			char     referenceID [16];
+			uint32_t pid             ;
+			char     patientID   [21];
+			char     padding     [ 3];
+			double   dob             ;
+			uint32_t vid             ;
+			char     visitID     [24];
+			double   visitDate       ;
+			int32_t  gridType        ;
+			int32_t  gridOffset      ;
+			char     spare       [ 8];
+			char     progID      [32];
+		});
+
+		PACKSTRUCT(struct VolBScanHeader
+		{
+			char     hsfOctRawStr[ 7];
+			char     version     [ 5];
+			uint32_t bscanHdrSize    ;
+			double   startX          ;
+			double   startY          ;
+			double   endX            ;
+			double   endY            ;
+			int32_t  numSeg          ;
+			int32_t  offSeg          ;
+			float    quality         ;
+			int32_t  shift           ;
+		});
+
+		constexpr const std::size_t volHeaderSize      = 2048;
+		constexpr const std::size_t volBScanHeaderSize = 456;
+		constexpr const std::size_t giplHeaderSize     = 256;
+		constexpr const uint32_t    giplMagicNumber    = 4026526128U;
+		constexpr const uint16_t    giplTypeUChar      = 8;
+
+		constexpr const double scanSizeMM = 6.;
+
+		// deterministic noise with a bright band, the readers don't care about the content
+		cv::Mat syntheticImage(int rows, int cols, int bscan)
+		{
+			cv::Mat image(rows, cols, cv::DataType<uint8_t>::type);
+			cv::RNG rng(static_cast<uint64_t>(bscan) + 1);
+			rng.fill(image, cv::RNG::UNIFORM, 0, 64);
+
+			const int bandStart = rows/3 + bscan%16;
+			cv::Mat band = image.rowRange(bandStart, std::min(rows, bandStart + rows/10));
+			band += cv::Scalar(128);
+			return image;
+		}
+
+		template<typename T>
+		void writeBinary(std::ostream& stream, const T& value)
+		{
+			stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+
+		void writeMat(std::ostream& stream, const cv::Mat& image)
+		{
+			const cv::Mat cont = image.isContinuous() ? image : image.clone();
+			stream.write(reinterpret_cast<const char*>(cont.data), static_cast<std::streamsize>(cont.total()*cont.elemSize()));
+		}
+
+		template<std::size_t N>
+		void copyString(char (&dest)[N], const char* str)
+		{
+			std::strncpy(dest, str, N);
+		}
+
+		// -------------------------------------------------------------------------------------------
+		// Heidelberg VOL: header, SLO, B-scans with B-scan header and float image
+
+		bfs::path writeVol(const bfs::path& dir, const SyntheticSize& size)
+		{
+			const bfs::path file = dir / "synthetic.vol";
+			std::ofstream stream(file, std::ios::binary);
+
+			VolFileHeader header{};
+			std::memcpy(header.magic, "HSF-OCT-", sizeof(header.magic));
+			copyString(header.version     , "103");
+			copyString(header.scanPosition, "OD");
+			copyString(header.id          , "BENCH");
+			copyString(header.patientID   , "BENCH0001");
+			copyString(header.progID      , "octdata_bench");
+
+			header.sizeX        = static_cast<uint32_t>(size.bscanWidth);
+			header.numBScans    = static_cast<uint32_t>(size.numBScans);
+			header.sizeZ        = static_cast<uint32_t>(size.bscanHeight);
+			header.scaleX       = scanSizeMM/size.bscanWidth;
+			header.distance     = scanSizeMM/size.numBScans;
+			header.scaleZ       = 0.0039;
+			header.sizeXSlo     = static_cast<uint32_t>(size.sloSize);
+			header.sizeYSlo     = static_cast<uint32_t>(size.sloSize);
+			header.scaleXSlo    = 3*scanSizeMM/size.sloSize;
+			header.scaleYSlo    = 3*scanSizeMM/size.sloSize;
+			header.fieldSizeSlo = 30;
+			header.scanPattern  = 3;
+			header.bScanHdrSize = static_cast<uint32_t>(volBScanHeaderSize);
+			header.pid          = 1;
+			header.vid          = 1;
+
+			writeBinary(stream, header);
+			const std::vector<char> headerPadding(volHeaderSize - sizeof(header), 0);
+			stream.write(headerPadding.data(), static_cast<std::streamsize>(headerPadding.size()));
+
+			writeMat(stream, syntheticImage(size.sloSize, size.sloSize, 0));
+
+			const std::vector<char> bscanPadding(volBScanHeaderSize - sizeof(VolBScanHeader), 0);
+			for(int i = 0; i < size.numBScans; ++i)
+			{
+				VolBScanHeader bscanHeader{};
+				std::memcpy(bscanHeader.hsfOctRawStr, "HSF-BS-", sizeof(bscanHeader.hsfOctRawStr));
+				copyString(bscanHeader.version, "103");
+				bscanHeader.bscanHdrSize = static_cast<uint32_t>(volBScanHeaderSize);
+				bscanHeader.startX       = scanSizeMM;
+				bscanHeader.endX         = 2*scanSizeMM;
+				bscanHeader.startY       = scanSizeMM + i*header.distance;
+				bscanHeader.endY         = bscanHeader.startY;
+				bscanHeader.offSeg       = 256;
+				bscanHeader.quality      = 30.f;
+
+				writeBinary(stream, bscanHeader);
+				stream.write(bscanPadding.data(), static_cast<std::streamsize>(bscanPadding.size()));
+
+				// the vol file stores the intensities as float, which are converted with the quad root
+				cv::Mat image;
+				syntheticImage(size.bscanHeight, size.bscanWidth, i).convertTo(image, cv::DataType<float>::type, 1./255.);
+				cv::pow(image, 4., image);
+				writeMat(stream, image);
+			}
+			return file;
+		}
+
+		// -------------------------------------------------------------------------------------------
+		// Cirrus raw: the metadata are in the filename, the volume is stored without header
+
+		bfs::path writeCirrus(const bfs::path& dir, const SyntheticSize& size)
+		{
+			const std::string filename = "BENCH0001_Macular Cube "
+			                           + std::to_string(size.bscanWidth) + "x" + std::to_string(size.numBScans)
+			                           + "_01-01-2020_12-00-00_OD_sn0001_cube_z.img";
+			const bfs::path file = dir / filename;
+			std::ofstream stream(file, std::ios::binary);
+
+			// each B-scan is stored transposed (A-scan after A-scan)
+			for(int i = 0; i < size.numBScans; ++i)
+				writeMat(stream, syntheticImage(size.bscanWidth, size.bscanHeight, i));
+
+			return file;
+		}
+
+		// -------------------------------------------------------------------------------------------
+		// GIPL: 256 byte big endian header, uint8 volume
+
+		void writeBigEndian(char* dest, uint32_t value, std::size_t bytes)
+		{
+			for(std::size_t i = 0; i < bytes; ++i)
+				dest[i] = static_cast<char>((value >> (8*(bytes-1-i))) & 0xFF);
+		}
+
+		bfs::path writeGipl(const bfs::path& dir, const SyntheticSize& size)
+		{
+			const bfs::path file = dir / "synthetic.gipl";
+			std::ofstream stream(file, std::ios::binary);
+
+			char header[giplHeaderSize] = {};
+			writeBigEndian(header + 0, static_cast<uint32_t>(size.bscanWidth ), 2);
+			writeBigEndian(header + 2, static_cast<uint32_t>(size.bscanHeight), 2);
+			writeBigEndian(header + 4, static_cast<uint32_t>(size.numBScans  ), 2);
+			writeBigEndian(header + 6, 1                                      , 2);
+			writeBigEndian(header + 8, giplTypeUChar                          , 2);
+			writeBigEndian(header + giplHeaderSize - 4, giplMagicNumber       , 4);
+			stream.write(header, giplHeaderSize);
+
+			for(int i = 0; i < size.numBScans; ++i)
+				writeMat(stream, syntheticImage(size.bscanHeight, size.bscanWidth, i));
+
+			return file;
+		}
+
+		// -------------------------------------------------------------------------------------------
+		// tiff stack: one 8 bit gray page per B-scan
+
+#ifdef TIFFSTACK_SUPPORT
+		bfs::path writeTiffStack(const bfs::path& dir, const SyntheticSize& size)
+		{
+			const bfs::path file = dir / "synthetic.tif";
+			TIFF* tif = TIFFOpen(file.generic_string().c_str(), "w");
+			if(!tif)
+				return bfs::path();
+
+			for(int i = 0; i < size.numBScans; ++i)
+			{
+				const cv::Mat image = syntheticImage(size.bscanHeight, size.bscanWidth, i);
+
+				TIFFSetField(tif, TIFFTAG_IMAGEWIDTH     , static_cast<uint32_t>(image.cols));
+				TIFFSetField(tif, TIFFTAG_IMAGELENGTH    , static_cast<uint32_t>(image.rows));
+				TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE  , 8);
+				TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, 1);
+				TIFFSetField(tif, TIFFTAG_PHOTOMETRIC    , PHOTOMETRIC_MINISBLACK);
+				TIFFSetField(tif, TIFFTAG_PLANARCONFIG   , PLANARCONFIG_CONTIG);
+				TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP   , static_cast<uint32_t>(image.rows));
+
+				for(int row = 0; row < image.rows; ++row)
+					TIFFWriteScanline(tif, const_cast<uint8_t*>(image.ptr<uint8_t>(row)), static_cast<uint32_t>(row), 0);
+				TIFFWriteDirectory(tif);
+			}
+			TIFFClose(tif);
+			return file;
+		}
+#endif
+
+		// -------------------------------------------------------------------------------------------
+		// xoct and cvbin: written by the library from a synthetic OCT object
+
+		OctData::OCT syntheticOct(const SyntheticSize& size)
+		{
+			OctData::OCT oct;
+			OctData::Patient& pat    = oct.getPatient(1);
+			OctData::Series&  series = pat.getStudy(1).getSeries(1);
+
+			pat.setId("BENCH0001");
+			series.setLaterality(OctData::Series::Laterality::OD);
+			series.setScanPattern(OctData::Series::ScanPattern::Volume);
+
+			std::unique_ptr<OctData::SloImage> slo = std::make_unique<OctData::SloImage>();
+			slo->setImage(syntheticImage(size.sloSize, size.sloSize, 0));
+			slo->setScaleFactor(OctData::ScaleFactor(3*scanSizeMM/size.sloSize, 3*scanSizeMM/size.sloSize));
+			series.takeSloImage(std::move(slo));
+
+			std::vector<std::shared_ptr<OctData::BScan>> bscans;
+			bscans.reserve(static_cast<std::size_t>(size.numBScans));
+			for(int i = 0; i < size.numBScans; ++i)
+			{
+				OctData::BScan::Data data;
+				data.scaleFactor = OctData::ScaleFactor(scanSizeMM/size.bscanWidth, scanSizeMM/size.numBScans, 0.0039);
+				data.start       = OctData::CoordSLOmm(scanSizeMM  , scanSizeMM + i*scanSizeMM/size.numBScans);
+				data.end         = OctData::CoordSLOmm(2*scanSizeMM, scanSizeMM + i*scanSizeMM/size.numBScans);
+				bscans.push_back(std::make_shared<OctData::BScan>(syntheticImage(size.bscanHeight, size.bscanWidth, i), data));
+			}
+			series.addBScans(std::move(bscans));
+
+			return oct;
+		}
+
+		bfs::path writeWithLibrary(const bfs::path& file, const SyntheticSize& size)
+		{
+			OctData::FileWriteOptions opt;
+			if(!OctData::OctFileRead::writeFile(file, syntheticOct(size), opt))
+				return bfs::path();
+			return file;
+		}
+
+		typedef bfs::path (*Generator)(const bfs::path& dir, const SyntheticSize& size);
+
+		struct FormatGenerator
+		{
+			const char* format;
+			Generator   generator;
+		};
+
+		const std::vector<FormatGenerator>& getGenerators()
+		{
+			static const std::vector<FormatGenerator> generators =
+			{
+#ifdef HE_VOL_SUPPORT
+				{ "vol"   , writeVol       },
+#endif
+#ifdef CIRRUS_RAW_SUPPORT
+				{ "cirrus", writeCirrus    },
+#endif
+#ifdef GIPL_SUPPORT
+				{ "gipl"  , writeGipl      },
+#endif
+#ifdef TIFFSTACK_SUPPORT
+				{ "tiff"  , writeTiffStack },
+#endif
+#ifdef XOCT_SUPPORT
+				{ "xoct"  , [](const bfs::path& dir, const SyntheticSize& size) { return writeWithLibrary(dir / "synthetic.xoct"  , size); } },
+#endif
+#ifdef CVBIN_SUPPORT
+				{ "cvbin" , [](const bfs::path& dir, const SyntheticSize& size) { return writeWithLibrary(dir / "synthetic.octbin", size); } },
+#endif
+			};
+			return generators;
+		}
+	}
+
+
+	std::vector<std::string> syntheticFormats()
+	{
+		std::vector<std::string> formats;
+		for(const FormatGenerator& gen : getGenerators())
+			formats.push_back(gen.format);
+		return formats;
+	}
+
+	std::vector<SyntheticFile> generateSyntheticFiles(const bfs::path& dir, const SyntheticSize& size, const std::vector<std::string>& formats)
+	{
+		bfs::create_directories(dir);
+
+		std::vector<SyntheticFile> files;
+		for(const FormatGenerator& gen : getGenerators())
+		{
+			if(!formats.empty() && std::find(formats.begin(), formats.end(), gen.format) == formats.end())
+				continue;
+
+			const bfs::path file = gen.generator(dir, size);
+			if(!file.empty() && bfs::exists(file))
+				files.push_back(SyntheticFile{gen.format, file});
+		}
+		return files;
+	}
+}
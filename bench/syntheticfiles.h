@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <filesystem>
+
+namespace OctDataBench
+{
+	// size of the generated volumes
+	struct SyntheticSize
+	{
+		int numBScans   = 128;
+		int bscanWidth  = 512; // A-scans per B-scan
+		int bscanHeight = 496; // pixel per A-scan
+		int sloSize     = 768;
+	};
+
+	// a generated file and the reader name for the result table
+	struct SyntheticFile
+	{
+		std::string           format;
+		std::filesystem::path path;
+	};
+
+	// structurally valid files with deterministic content, written in dir
+	// only the formats which are build in the library are generated
+	std::vector<SyntheticFile> generateSyntheticFiles(const std::filesystem::path& dir, const SyntheticSize& size, const std::vector<std::string>& formats);
+
+	std::vector<std::string> syntheticFormats();
+}
@@ -23,6 +23,8 @@
 
 #include <opencv2/opencv.hpp>
 
+#include "bscanimagecache.h"
+
 
 namespace OctData
 {
@@ -36,8 +38,24 @@ namespace OctData
 
 	}
 
+	BScan::BScan(ImageLoader loader, int width, int height, const BScan::Data& data, std::shared_ptr<BScanImageCache> cache)
+	: image      (new cv::Mat)
+	, angioImage (new cv::Mat)
+	, rawImage   (new cv::Mat)
+	, data       (data)
+	, imageLoader(std::move(loader))
+	, imageCache (std::move(cache))
+	, lazyWidth  (width)
+	, lazyHeight (height)
+	{
+
+	}
+
 	BScan::~BScan()
 	{
+		if(imageCache)
+			imageCache->remove(this);
+
 		delete image;
 		delete angioImage;
 		delete rawImage;
@@ -45,14 +63,62 @@ namespace OctData
 
 	int BScan::getWidth() const
 	{
+		if(imageLoader)
+			return lazyWidth;
 		return image->cols;
 	}
 
 	int BScan::getHeight() const
 	{
+		if(imageLoader)
+			return lazyHeight;
 		return image->rows;
 	}
 
+	cv::Mat BScan::getImage() const
+	{
+		return getImageMat(*image);
+	}
+
+	cv::Mat BScan::getRawImage() const
+	{
+		return getImageMat(*rawImage);
+	}
+
+	cv::Mat BScan::getImageMat(const cv::Mat& mat) const
+	{
+		if(!imageLoader)
+			return mat;
+
+		cv::Mat result;
+		{
+			std::lock_guard<std::mutex> lock(loadMutex);
+			if(!imageLoaded)
+			{
+				cv::Mat img;
+				cv::Mat raw;
+				imageLoader(img, raw);
+				*image    = img;
+				*rawImage = raw;
+				imageLoaded = true;
+			}
+			// copy under the lock, a release by the cache only drops the reference of this B-scan
+			result = mat;
+		}
+		// every access (least recently used), outside of the lock, the cache locks the released B-scans
+		if(imageCache)
+			imageCache->touch(this);
+		return result;
+	}
+
+	void BScan::releaseImage() const
+	{
+		std::lock_guard<std::mutex> lock(loadMutex);
+		*image    = cv::Mat();
+		*rawImage = cv::Mat();
+		imageLoaded = false;
+	}
+
 	void BScan::setRawImage(const cv::Mat& img)
 	{
 		*rawImage = img;
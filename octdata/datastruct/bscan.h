@@ -19,6 +19,10 @@
 
 #include <vector>
 #include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include "coordslo.h"
 #include "date.h"
 #include "segmentationlines.h"
@@ -35,13 +39,18 @@ namespace cv { class Mat; }
 
 namespace OctData
 {
+	class BScanImageCache;
 
 	// GCL IPL INL OPL ELM PR1 PR2 RPE BM
 	class Octdata_EXPORTS BScan
 	{
+		friend class BScanImageCache;
 	public:
 		enum class BScanType { Unknown, Line, Circle };
 
+		// fills image and raw image (optional) of a lazy loaded B-scan, can be called from any thread
+		typedef std::function<void(cv::Mat& image, cv::Mat& rawImage)> ImageLoader;
+
 		typedef ObjectWrapper<BScanType> BScanTypeEnumWrapper;
 
 		struct Data
@@ -73,14 +82,24 @@ namespace OctData
 
 		// BScan();
 		BScan(const cv::Mat& img, const BScan::Data& data);
+		/**
+		 * lazy B-scan, the images are loaded on the first access of getImage() or getRawImage()
+		 * with a cache the images can be released again when other B-scans are loaded,
+		 * the returned cv::Mat keeps the image data alive, the loader has to fill images which own their data
+		 */
+		BScan(ImageLoader loader, int width, int height, const BScan::Data& data, std::shared_ptr<BScanImageCache> cache = nullptr);
 		~BScan();
 
 		BScan(const BScan& other)            = delete;
 		BScan& operator=(const BScan& other) = delete;
 
-		const cv::Mat& getImage()           const                   { return *image                      ; }
+		// copies of the header (no image data), a lazy B-scan can release its images at any time
+		cv::Mat getImage()                  const;
 		const cv::Mat& getAngioImage()      const                   { return *angioImage                 ; }
-		const cv::Mat& getRawImage()        const                   { return *rawImage                   ; }
+		cv::Mat getRawImage()               const;
+
+		bool isLazy()                       const                   { return static_cast<bool>(imageLoader); }
+		bool isImageLoaded()                const                   { return !imageLoader || imageLoaded ; }
 
 		void setRawImage(const cv::Mat& img);
 		void setAngioImage(const cv::Mat& img);
@@ -127,6 +146,16 @@ namespace OctData
 		cv::Mat*                                rawImage   = nullptr;
 		Data                                    data;
 
+		ImageLoader                             imageLoader;
+		std::shared_ptr<BScanImageCache>        imageCache;
+		int                                     lazyWidth  = 0;
+		int                                     lazyHeight = 0;
+		mutable std::atomic<bool>               imageLoaded{false};
+		mutable std::mutex                      loadMutex;
+
+		cv::Mat getImageMat(const cv::Mat& mat) const;
+		void releaseImage() const;
+
 
 		template<typename T, typename ParameterSet>
 		static void callSubset(T& getSet, ParameterSet& p, const std::string& name)
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bscanimagecache.h"
+
+#include "bscan.h"
+
+namespace OctData
+{
+
+	BScanImageCache::BScanImageCache(std::size_t maxImages)
+	: maxImages(maxImages)
+	{
+	}
+
+	void BScanImageCache::touch(const BScan* bscan)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		auto it = positions.find(bscan);
+		if(it != positions.end())
+		{
+			usage.splice(usage.begin(), usage, it->second);
+			return;
+		}
+
+		usage.push_front(bscan);
+		positions.emplace(bscan, usage.begin());
+
+		while(maxImages > 0 && usage.size() > maxImages)
+		{
+			const BScan* oldest = usage.back();
+			usage.pop_back();
+			positions.erase(oldest);
+			oldest->releaseImage();
+		}
+	}
+
+	void BScanImageCache::remove(const BScan* bscan)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		auto it = positions.find(bscan);
+		if(it == positions.end())
+			return;
+
+		usage.erase(it->second);
+		positions.erase(it);
+	}
+
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+
+#ifdef OCTDATA_EXPORT
+	#include "octdata_EXPORTS.h"
+#else
+	#define Octdata_EXPORTS
+#endif
+
+namespace OctData
+{
+	class BScan;
+
+	/**
+	 * bounded cache for lazy loaded B-scans, the images of the least recently used B-scans
+	 * are released when more than maxImages are loaded (0: no limit)
+	 */
+	class BScanImageCache
+	{
+		typedef std::list<const BScan*> UsageList;
+
+		const std::size_t maxImages;
+
+		std::mutex mutex;
+		UsageList  usage;
+		std::unordered_map<const BScan*, UsageList::iterator> positions;
+
+	public:
+		Octdata_EXPORTS explicit BScanImageCache(std::size_t maxImages);
+
+		BScanImageCache(const BScanImageCache&)            = delete;
+		BScanImageCache& operator=(const BScanImageCache&) = delete;
+
+		Octdata_EXPORTS std::size_t getMaxImages()        const { return maxImages; }
+
+		Octdata_EXPORTS void touch (const BScan* bscan);
+		Octdata_EXPORTS void remove(const BScan* bscan);
+	};
+}
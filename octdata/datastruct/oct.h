@@ -21,17 +21,22 @@
 #include "patient.h"
 
 #include <tuple>
+#include <vector>
 
 namespace OctData
 {
 	class OCT : public SubstructureTemplate<Patient>
 	{
+		std::vector<std::shared_ptr<const void>> fileMappings;
 	public:
 		Octdata_EXPORTS       Patient& getInsertId(int id)                        { return getAndInsert        (id) ; }
 
 		Octdata_EXPORTS       Patient& getPatient(int patientId)                  { return getAndInsert        (patientId) ; }
 		Octdata_EXPORTS const Patient& getPatient(int patientId) const            { return *(substructureMap.at(patientId)); }
-		Octdata_EXPORTS void clear()                                              { clearSubstructure(); }
+		Octdata_EXPORTS void clear()                                              { clearSubstructure(); fileMappings.clear(); }
+
+		// images on memory mapped files (see FileReader::mapRegion) are valid as long as this OCT object exists
+		Octdata_EXPORTS void holdFileMapping(std::shared_ptr<const void> owner)   { if(owner) fileMappings.push_back(std::move(owner)); }
 
 		Octdata_EXPORTS std::tuple<std::shared_ptr<const Patient>, std::shared_ptr<const Study>> findSeries(const std::shared_ptr<const Series>& seriesReq) const;
 
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "octmetadata.h"
+
+#include "oct.h"
+#include "bscan.h"
+#include "sloimage.h"
+
+namespace OctData
+{
+	SeriesMetadata::SeriesMetadata(const Patient& pat, const Study& study, const Series& series)
+	: patientInternalId(pat   .getInternalId())
+	, studyInternalId  (study .getInternalId())
+	, seriesInternalId (series.getInternalId())
+	, patientId        (pat.getId())
+	, patientUID       (pat.getPatientUID())
+	, forename         (pat.getForename())
+	, surname          (pat.getSurname())
+	, sex              (pat.getSex())
+	, birthdate        (pat.getBirthdate())
+	, studyUID         (study.getStudyUID())
+	, studyName        (study.getStudyName())
+	, studyDate        (study.getStudyDate())
+	, seriesUID        (series.getSeriesUID())
+	, refSeriesUID     (series.getRefSeriesUID())
+	, description      (series.getDescription())
+	, scanPattern      (series.getScanPattern())
+	, scanPatternText  (series.getScanPatternText())
+	, examinedStructure(series.getExaminedStructure())
+	, laterality       (series.getLaterality())
+	, scanDate         (series.getScanDate())
+	{
+	}
+
+	SeriesMetadata& OctMetadata::addSeries(const Patient& pat, const Study& study, const Series& s)
+	{
+		series.emplace_back(pat, study, s);
+		return series.back();
+	}
+
+	OctMetadata OctMetadata::fromOCT(const OCT& oct, bool bscansRead)
+	{
+		OctMetadata metadata;
+		for(const OCT::SubstructurePair& patPair : oct)
+		{
+			const Patient& pat = *patPair.second;
+			for(const Patient::SubstructurePair& studyPair : pat)
+			{
+				const Study& study = *studyPair.second;
+				for(const Study::SubstructurePair& seriesPair : study)
+				{
+					const Series& series = *seriesPair.second;
+					SeriesMetadata& entry = metadata.addSeries(pat, study, series);
+
+					if(bscansRead)
+						entry.numBScans = series.bscanCount();
+					if(entry.numBScans > 0)
+					{
+						const std::shared_ptr<const BScan> bscan = series.getBScan(0);
+						if(bscan)
+						{
+							entry.bscanWidth  = bscan->getWidth();
+							entry.bscanHeight = bscan->getHeight();
+						}
+					}
+
+					const SloImage& slo = series.getSloImage();
+					entry.sloWidth  = slo.getWidth();
+					entry.sloHeight = slo.getHeight();
+				}
+			}
+		}
+		return metadata;
+	}
+
+}
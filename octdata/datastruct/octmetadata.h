@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "patient.h"
+
+#ifdef OCTDATA_EXPORT
+	#include "octdata_EXPORTS.h"
+#else
+	#define Octdata_EXPORTS
+#endif
+
+namespace OctData
+{
+	class OCT;
+
+	/**
+	 * patient, study and series data of one series without any image data, result of OctFileRead::scanMetadata()
+	 * sizes are 0 if the reader can't get them from the file header
+	 */
+	class SeriesMetadata
+	{
+	public:
+		int                          patientInternalId = 0;
+		int                          studyInternalId   = 0;
+		int                          seriesInternalId  = 0;
+
+		std::string                  patientId;
+		std::string                  patientUID;
+		std::string                  forename;
+		std::string                  surname;
+		Patient::Sex                 sex               = Patient::Sex::Unknown;
+		Date                         birthdate;
+
+		std::string                  studyUID;
+		std::string                  studyName;
+		Date                         studyDate;
+
+		std::string                  seriesUID;
+		std::string                  refSeriesUID;
+		std::string                  description;
+		Series::ScanPattern          scanPattern       = Series::ScanPattern::Unknown;
+		std::string                  scanPatternText;
+		Series::ExaminedStructure    examinedStructure = Series::ExaminedStructure::Unknown;
+		Series::Laterality           laterality        = Series::Laterality::undef;
+		Date                         scanDate;
+
+		std::size_t                  numBScans         = 0;
+		int                          bscanWidth        = 0;
+		int                          bscanHeight       = 0;
+		int                          sloWidth          = 0;
+		int                          sloHeight         = 0;
+
+		Octdata_EXPORTS SeriesMetadata() = default;
+		Octdata_EXPORTS SeriesMetadata(const Patient& pat, const Study& study, const Series& series);
+	};
+
+	class OctMetadata
+	{
+	public:
+		typedef std::vector<SeriesMetadata> SeriesList;
+
+		Octdata_EXPORTS const SeriesList& getSeries()                  const { return series; }
+		Octdata_EXPORTS bool empty()                                   const { return series.empty(); }
+
+		Octdata_EXPORTS SeriesMetadata& addSeries(const Patient& pat, const Study& study, const Series& series);
+
+		/**
+		 * metadata of all series in oct, the sizes are taken from the loaded images
+		 * bscansRead: false if oct was read without the B-scans, the B-scan count and size are unknown (0)
+		 */
+		Octdata_EXPORTS static OctMetadata fromOCT(const OCT& oct, bool bscansRead = true);
+
+	private:
+		SeriesList series;
+	};
+
+}
@@ -20,6 +20,8 @@
 #include "bscan.h"
 #include "sloimage.h"
 
+#include <opencv2/opencv.hpp>
+
 #include <limits>
 
 #define _USE_MATH_DEFINES
@@ -37,6 +39,7 @@ namespace OctData
 	    : internalId(internalId)
 	    , sloImage(std::make_unique<SloImage>())
 	    , scanFocus(std::numeric_limits<double>::quiet_NaN())
+	    , volume(std::make_unique<cv::Mat>())
 	{
 
 	}
@@ -44,11 +47,53 @@ namespace OctData
 
 	Series::~Series() = default;
 
+	bool Series::hasVolume() const
+	{
+		return !volume->empty();
+	}
+
+	cv::Mat& Series::createVolume(int numBScans, int height, int width, int type)
+	{
+		const int sizes[] = { numBScans, height, width };
+		volume->create(3, sizes, type);
+		return *volume;
+	}
+
+	void Series::setVolume(const cv::Mat& vol)
+	{
+		*volume = vol;
+	}
+
+	cv::Mat Series::getVolumeSlice(int bscan) const
+	{
+		if(volume->dims != 3 || bscan < 0 || bscan >= volume->size[0])
+			return cv::Mat();
+
+		const cv::Range ranges[] = { cv::Range(bscan, bscan+1), cv::Range::all(), cv::Range::all() };
+		const int sliceSize[] = { volume->size[1], volume->size[2] };
+		return (*volume)(ranges).reshape(0, 2, sliceSize); // shares the data and the reference counter with the volume
+	}
+
 	void Series::addBScan(std::shared_ptr<BScan> bscan)
 	{
 		bscans.push_back(std::move(bscan));
-		calculateSLOConvexHull();
-		updateCornerCoords();
+		updateCornerCoords(bscans.size()-1);
+		calculateSLOConvexHull(bscans.size()-1);
+	}
+
+	void Series::addBScans(std::vector<std::shared_ptr<BScan>> newBScans)
+	{
+		if(newBScans.empty())
+			return;
+
+		const std::size_t first = bscans.size();
+		bscans.reserve(first + newBScans.size());
+		for(std::shared_ptr<BScan>& bscan : newBScans)
+		{
+			bscans.push_back(std::move(bscan));
+			updateCornerCoords(bscans.size()-1);
+		}
+		calculateSLOConvexHull(first);
 	}
 
 	const std::shared_ptr<const BScan> Series::getBScan(std::size_t pos) const
@@ -77,16 +122,13 @@ namespace OctData
 		rightLower = CoordSLOmm(maxX, maxY);
 	}
 
-	void Series::updateCornerCoords()
+	void Series::updateCornerCoords(std::size_t bscanIndex)
 	{
-		if(bscans.empty())
-			return;
-		
-		const std::shared_ptr<const BScan>& bscan = bscans.back();
+		const std::shared_ptr<const BScan>& bscan = bscans[bscanIndex];
 		if(!bscan)
 			return;
 
-		if(bscans.size() == 1) // first scan, init points
+		if(bscanIndex == 0) // first scan, init points
 		{
 			leftUpper  = bscan->getStart();
 			rightLower = bscan->getStart();
@@ -111,10 +153,12 @@ namespace OctData
 		}
 	}
 
-	void Series::calculateSLOConvexHull()
+	/**
+	 * the hull of all B-scans is the hull of the old hull points and the points of the new B-scans,
+	 * so adding B-scans costs O(hull + new points) instead of a recalculation over the whole series
+	 */
+	void Series::calculateSLOConvexHull(std::size_t firstNewBScan)
 	{
-		convexHullSLOBScans.clear();
-
 		typedef boost::geometry::model::d2::point_xy<double> Point;
 		typedef boost::geometry::model::polygon<Point> Polygon;
 		typedef std::vector<Point> PointsList;
@@ -137,8 +181,12 @@ namespace OctData
 		};
 
 		PointsList points;
-		for(const BScanList::value_type& bscan : bscans)
+		for(const CoordSLOmm& pt : convexHullSLOBScans)
+			Adder::addPoint(points, pt);
+
+		for(std::size_t i = firstNewBScan; i < bscans.size(); ++i)
 		{
+			const BScanList::value_type& bscan = bscans[i];
 			if(bscan)
 			{
 				if(bscan->getCenter())
@@ -158,6 +206,7 @@ namespace OctData
 		boost::geometry::convex_hull(poly, hull);
 
 		// ring is a vector
+		convexHullSLOBScans.clear();
 		std::vector<Point> const& convexPoints = hull.outer();
 		for(const Point&p : convexPoints)
 			convexHullSLOBScans.emplace_back(p.get<0>(), p.get<1>());
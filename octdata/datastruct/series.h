@@ -26,6 +26,7 @@
 
 #include"objectwrapper.h"
 
+namespace cv { class Mat; }
 
 #ifdef OCTDATA_EXPORT
 	#include "octdata_EXPORTS.h"
@@ -95,6 +96,20 @@ namespace OctData
 		Octdata_EXPORTS double getScanFocus()                    const { return scanFocus;  }
 
 		Octdata_EXPORTS void addBScan(std::shared_ptr<BScan> bscan);
+		// adds all B-scans in order, the convex hull is updated once
+		Octdata_EXPORTS void addBScans(std::vector<std::shared_ptr<BScan>> bscans);
+
+		/**
+		 * optional contiguous volume (numBScans x height x width) as one 3D cv::Mat,
+		 * readers which know the dimensions up front create it and use getVolumeSlice() as B-scan images,
+		 * empty if the B-scans are separate images
+		 */
+		Octdata_EXPORTS bool hasVolume()                         const;
+		Octdata_EXPORTS const cv::Mat& getVolume()               const { return *volume; }
+		Octdata_EXPORTS cv::Mat& createVolume(int numBScans, int height, int width, int type);
+		Octdata_EXPORTS void setVolume(const cv::Mat& vol);
+		// 2D header of one B-scan in the volume without copy, the data stays valid as long as the header exists
+		Octdata_EXPORTS cv::Mat getVolumeSlice(int bscan)        const;
 
 		Octdata_EXPORTS void setDescription(const std::string& text)   { description = text; }
 		Octdata_EXPORTS const std::string& getDescription()      const { return description; }
@@ -132,14 +147,15 @@ namespace OctData
 		std::string                             description;
 
 		BScanList                               bscans;
+		std::unique_ptr<cv::Mat>                volume;
 
 		AnalyseGrid                             analyseGrid;
 
 		BScanSLOCoordList                       convexHullSLOBScans;
 		CoordSLOmm                              leftUpper;
 		CoordSLOmm                              rightLower;
-		void calculateSLOConvexHull();
-		void updateCornerCoords();
+		void calculateSLOConvexHull(std::size_t firstNewBScan);
+		void updateCornerCoords(std::size_t bscanIndex);
 		void updateCornerCoords(const CoordSLOmm& point);
 
 
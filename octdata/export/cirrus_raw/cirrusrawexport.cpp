@@ -22,6 +22,8 @@
 #include<iomanip>
 #include<memory>
 #include<filesystem>
+#include<vector>
+#include<algorithm>
 
 #include<opencv2/opencv.hpp>
 
@@ -33,6 +35,7 @@
 #include<oct_cpp_framework/callback.h>
 
 #include<filereader/filereader.h>
+#include<imgproc/reversebytes.h>
 
 #include<datastruct/oct.h>
 #include<datastruct/coordslo.h>
@@ -58,19 +61,14 @@ namespace OctData
 			const int cols = std::min(bscan.cols, static_cast<int>(sizeX));
 			const int rows = std::min(bscan.rows, static_cast<int>(sizeY));
 
+			// the reversed row is right-aligned in the destination row
 			for(int r = 0; r < rows; ++r)
-			{
-				const uint8_t* sourceIt = bscan.ptr<uint8_t>(r);
-				      uint8_t* destIt   = dest+(rows-r)*sizeX;
-				for(int c = 0; c < cols; ++c)
-				{
-					--destIt;
-					*destIt = *sourceIt;
-					++sourceIt;
-				}
-			}
+				reverseBytes(bscan.ptr<uint8_t>(r), dest + (rows-r)*sizeX - static_cast<std::size_t>(cols), static_cast<std::size_t>(cols));
 		}
 
+		// B-scans per write call
+		const std::size_t writeChunkSize = 32*1024*1024;
+
 		inline std::string avoidEmptyString(const std::string& str)
 		{
 			if(str.empty())
@@ -187,9 +185,17 @@ namespace OctData
 		bfs::path exportpath = file.parent_path() / filename;
 
 		std::ofstream stream(exportpath.generic_string(), std::ios_base::binary);
+		if(!stream.good())
+		{
+			BOOST_LOG_TRIVIAL(error) << "CirrusRawExport: can't open " << exportpath.generic_string();
+			return false;
+		}
 
-		std::unique_ptr<uint8_t> cache(new uint8_t[cubeSizeX*cubeSizeY*cubeSizeZ]);
-		uint8_t* cacheIt = cache.get();
+		// the B-scans are written in chunks, only the buffer of one chunk is needed
+		const std::size_t bscanSize   = cubeSizeX*cubeSizeY;
+		const std::size_t chunkBScans = std::max(std::size_t(1), writeChunkSize/std::max(bscanSize, std::size_t(1)));
+		std::vector<uint8_t> chunk(std::min(chunkBScans, cubeSizeZ)*bscanSize);
+		std::size_t chunkFill = 0;
 
 		const OctData::Series::BScanList& bscans = series.getBScans();
 		      OctData::Series::BScanList::const_reverse_iterator beginIt = bscans.crbegin();
@@ -200,15 +206,24 @@ namespace OctData
 
 		while(endIt != beginIt)
 		{
+			uint8_t* bscanDest = chunk.data() + chunkFill*bscanSize;
+			std::fill(bscanDest, bscanDest + bscanSize, uint8_t(0)); // smaller or missing B-scans
 			if(*beginIt)
-				writeFliped((*beginIt)->getImage(), cacheIt, cubeSizeX, cubeSizeY);
+				writeFliped((*beginIt)->getImage(), bscanDest, cubeSizeX, cubeSizeY);
 
-			cacheIt += cubeSizeX*cubeSizeY;
 			++beginIt;
+			if(++chunkFill == chunkBScans || endIt == beginIt)
+			{
+				stream.write(reinterpret_cast<char*>(chunk.data()), static_cast<std::streamsize>(chunkFill*bscanSize));
+				chunkFill = 0;
+			}
 		}
 
-		stream.write(reinterpret_cast<char*>(cache.get()), cubeSizeX*cubeSizeY*cubeSizeZ);
-
+		if(!stream.good())
+		{
+			BOOST_LOG_TRIVIAL(error) << "CirrusRawExport: write error " << exportpath.generic_string();
+			return false;
+		}
 
 		return true;
 	}
@@ -65,13 +65,51 @@ namespace OctData
 			imgNode.getMat() = image;
 		}
 
-		void writeBScan(CppFW::CVMatTree& seriesNode, const std::shared_ptr<const BScan>& bscan)
+		// B-scan images of a series in an own file, the entries of the list in the file have the same order as the B-scans in the main file
+		class SeriesFileIndex
+		{
+			const bfs::path mainFile;
+			int             numSeriesFiles = 0;
+			bool            result         = true;
+
+		public:
+			explicit SeriesFileIndex(const bfs::path& mainFile) : mainFile(mainFile) {}
+
+			bfs::path newSeriesFile()
+			{
+				++numSeriesFiles;
+				return mainFile.parent_path() / (mainFile.stem().generic_string() + "_series" + boost::lexical_cast<std::string>(numSeriesFiles) + mainFile.extension().generic_string());
+			}
+
+			void writeSeriesFile(const bfs::path& file, const CppFW::CVMatTree& tree)
+			{
+				if(!CppFW::CVMatTreeStructBin::writeBin(file.generic_string(), tree))
+				{
+					BOOST_LOG_TRIVIAL(error) << "Can't write octbin series file " << file.generic_string();
+					result = false;
+				}
+			}
+
+			bool getResult()                                     const { return result; }
+		};
+
+
+		void writeBScan(CppFW::CVMatTree& seriesNode, const std::shared_ptr<const BScan>& bscan, CppFW::CVMatTree* imageListNode = nullptr)
 		{
 			if(!bscan)
 				return;
 
 			CppFW::CVMatTree& bscanNode = seriesNode.newListNode();
-			writeImage(bscanNode, bscan->getImage()     , "img"     );
+			if(imageListNode)
+			{
+				// the main file holds only the image size, the B-scan can be created without loading the image
+				const cv::Mat& image = bscan->getImage();
+				writeImage(imageListNode->newListNode(), image, "img");
+				CppFW::CVMatTreeExtra::setCvScalar(bscanNode, "imgWidth" , image.cols);
+				CppFW::CVMatTreeExtra::setCvScalar(bscanNode, "imgHeight", image.rows);
+			}
+			else
+				writeImage(bscanNode, bscan->getImage(), "img");
 			writeImage(bscanNode, bscan->getAngioImage(), "angioImg");
 
 			CppFW::CVMatTree& bscanDataNode = bscanNode.getDirNode("data");
@@ -80,17 +118,18 @@ namespace OctData
 
 			CppFW::CVMatTree& bscanSegNode = bscanNode.getDirNode("segmentations");
 
+			// the matrix uses the buffer of the segmentation line (no copy), the tree is only used while the OCT object exists
 			for(OctData::Segmentationlines::SegmentlineType type : OctData::Segmentationlines::getSegmentlineTypes())
 			{
 				const Segmentationlines::Segmentline& seg = bscan->getSegmentLine(type);
 				if(!seg.empty())
-					bscanSegNode.getDirNode(Segmentationlines::getSegmentlineName(type)).getMat() = cv::Mat(1, static_cast<int>(seg.size()), cv::DataType<Segmentationlines::SegmentlineDataType>::type, const_cast<Segmentationlines::SegmentlineDataType*>(seg.data())).clone();
+					bscanSegNode.getDirNode(Segmentationlines::getSegmentlineName(type)).getMat() = cv::Mat(1, static_cast<int>(seg.size()), cv::DataType<Segmentationlines::SegmentlineDataType>::type, const_cast<Segmentationlines::SegmentlineDataType*>(seg.data()));
 			}
 		}
 
 		// deep file format (support many scans per file, tree structure)
 		template<typename S>
-		bool writeStructure(CppFW::CVMatTree& tree, const S& structure)
+		bool writeStructure(CppFW::CVMatTree& tree, const S& structure, SeriesFileIndex* seriesFileIndex)
 		{
 			bool result = true;
 			CppFW::CVMatTree& dataNode    = tree.getDirNode("data");
@@ -101,14 +140,14 @@ namespace OctData
 			for(typename S::SubstructurePair const& subStructPair : structure)
 			{
 				CppFW::CVMatTree& subNode = tree.getDirNode("id_" + boost::lexical_cast<std::string>(subStructPair.first));
-				result &= writeStructure(subNode, *subStructPair.second);
+				result &= writeStructure(subNode, *subStructPair.second, seriesFileIndex);
 			}
 			return result;
 		}
 
 
 		template<>
-		bool writeStructure<Series>(CppFW::CVMatTree& tree, const Series& series)
+		bool writeStructure<Series>(CppFW::CVMatTree& tree, const Series& series, SeriesFileIndex* seriesFileIndex)
 		{
 			CppFW::CVMatTree& seriesDataNode = tree.getDirNode("data");
 			CppFW::SetToCVMatTree seriesWriter(seriesDataNode);
@@ -119,8 +158,22 @@ namespace OctData
 
 			CppFW::CVMatTree& seriesNode = tree.getDirNode("bscans");
 
-			for(const std::shared_ptr<const BScan>& bscan : series.getBScans())
-				writeBScan(seriesNode, bscan);
+			if(seriesFileIndex)
+			{
+				CppFW::CVMatTree seriesImageTree;
+				CppFW::CVMatTree& imageListNode = seriesImageTree.getDirNode("bscans");
+				for(const std::shared_ptr<const BScan>& bscan : series.getBScans())
+					writeBScan(seriesNode, bscan, &imageListNode);
+
+				const bfs::path seriesFile = seriesFileIndex->newSeriesFile();
+				seriesFileIndex->writeSeriesFile(seriesFile, seriesImageTree);
+				tree.getDirNode("bscansFile").getString() = seriesFile.filename().generic_string();
+			}
+			else
+			{
+				for(const std::shared_ptr<const BScan>& bscan : series.getBScans())
+					writeBScan(seriesNode, bscan);
+			}
 
 			return true;
 		}
@@ -184,6 +237,11 @@ namespace OctData
 			tree.getDirNode(nodeName).getString() = value;
 	}
 
+	/**
+	 * the tree holds only headers of the images and segmentation lines of oct, no pixel data is copied
+	 * (a node by node output would need a streaming interface of CppFW::CVMatTreeStructBin)
+	 * with octBinSeriesFiles the images of every series are written to the series file before the next series is processed
+	 */
 	bool CvBinOctWrite::writeFile(const std::filesystem::path& file, const OCT& oct, const FileWriteOptions& opt)
 	{
 		CppFW::CVMatTree octtree;
@@ -191,8 +249,14 @@ namespace OctData
 		bool result;
 		if(opt.octBinFlat)
 			result = writeFlatFile(octtree, oct);
+		else if(opt.octBinSeriesFiles)
+		{
+			SeriesFileIndex seriesFileIndex(file);
+			result  = writeStructure(octtree, oct, &seriesFileIndex);
+			result &= seriesFileIndex.getResult();
+		}
 		else
-			result = writeStructure(octtree, oct);
+			result = writeStructure(octtree, oct, nullptr);
 
 // 		if(result)
 		result &= CppFW::CVMatTreeStructBin::writeBin(file.generic_string(), octtree);
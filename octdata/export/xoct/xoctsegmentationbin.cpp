@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "xoctsegmentationbin.h"
+
+#include <cstring>
+#include <string>
+
+#include <boost/endian/conversion.hpp>
+
+namespace OctData
+{
+	namespace
+	{
+		const char magic[8] = { 'X', 'O', 'C', 'T', 'S', 'E', 'G', '\0' };
+
+		typedef double ValueType;
+		static_assert(sizeof(ValueType) == sizeof(uint64_t), "float64 expected");
+
+		class BinWriter
+		{
+			std::vector<unsigned char>& data;
+		public:
+			BinWriter(std::vector<unsigned char>& data) : data(data) {}
+
+			void writeBytes(const void* bytes, std::size_t size)
+			{
+				const unsigned char* ptr = static_cast<const unsigned char*>(bytes);
+				data.insert(data.end(), ptr, ptr + size);
+			}
+
+			void writeUInt32(uint32_t value)
+			{
+				boost::endian::native_to_little_inplace(value);
+				writeBytes(&value, sizeof(value));
+			}
+
+			void writeValues(const Segmentationlines::Segmentline& line)
+			{
+				const std::size_t pos = data.size();
+				data.resize(pos + line.size()*sizeof(ValueType));
+				unsigned char* dest = data.data() + pos;
+				for(const ValueType value : line)
+				{
+					uint64_t bits;
+					std::memcpy(&bits, &value, sizeof(bits));
+					boost::endian::native_to_little_inplace(bits);
+					std::memcpy(dest, &bits, sizeof(bits));
+					dest += sizeof(bits);
+				}
+			}
+		};
+
+		class BinReader
+		{
+			const char* pos;
+			const char* end;
+		public:
+			BinReader(const std::vector<char>& data) : pos(data.data()), end(data.data() + data.size()) {}
+
+			std::size_t remaining() const                                  { return static_cast<std::size_t>(end - pos); }
+
+			bool readBytes(void* dest, std::size_t size)
+			{
+				if(remaining() < size)
+					return false;
+				std::memcpy(dest, pos, size);
+				pos += size;
+				return true;
+			}
+
+			bool readUInt32(uint32_t& value)
+			{
+				if(!readBytes(&value, sizeof(value)))
+					return false;
+				boost::endian::little_to_native_inplace(value);
+				return true;
+			}
+
+			bool readValues(Segmentationlines::Segmentline* line, uint32_t numValues)
+			{
+				const std::size_t size = static_cast<std::size_t>(numValues)*sizeof(ValueType);
+				if(remaining() < size)
+					return false;
+
+				if(line)
+				{
+					line->resize(numValues);
+					for(ValueType& value : *line)
+					{
+						uint64_t bits;
+						std::memcpy(&bits, pos, sizeof(bits));
+						boost::endian::little_to_native_inplace(bits);
+						std::memcpy(&value, &bits, sizeof(bits));
+						pos += sizeof(bits);
+					}
+				}
+				else
+					pos += size;
+				return true;
+			}
+		};
+
+		const Segmentationlines::SegmentlineType* findSegmentlineType(const std::string& name)
+		{
+			for(const Segmentationlines::SegmentlineType& type : Segmentationlines::getSegmentlineTypes())
+				if(name == Segmentationlines::getSegmentlineName(type))
+					return &type;
+			return nullptr;
+		}
+	}
+
+
+	std::vector<unsigned char> XOctSegmentationBin::write(const std::vector<const Segmentationlines*>& bscanSegmentations)
+	{
+		// only the lines which are used by any B-scan
+		std::vector<Segmentationlines::SegmentlineType> usedLines;
+		for(Segmentationlines::SegmentlineType type : Segmentationlines::getSegmentlineTypes())
+		{
+			for(const Segmentationlines* seglines : bscanSegmentations)
+			{
+				if(!seglines->getSegmentLine(type).empty())
+				{
+					usedLines.push_back(type);
+					break;
+				}
+			}
+		}
+
+		std::vector<unsigned char> data;
+		BinWriter writer(data);
+
+		writer.writeBytes(magic, sizeof(magic));
+		writer.writeUInt32(version);
+		writer.writeUInt32(sizeof(ValueType));
+		writer.writeUInt32(static_cast<uint32_t>(bscanSegmentations.size()));
+		writer.writeUInt32(static_cast<uint32_t>(usedLines.size()));
+
+		for(Segmentationlines::SegmentlineType type : usedLines)
+		{
+			const char* name = Segmentationlines::getSegmentlineName(type);
+			const uint32_t nameLength = static_cast<uint32_t>(std::strlen(name));
+			writer.writeUInt32(nameLength);
+			writer.writeBytes(name, nameLength);
+		}
+
+		for(const Segmentationlines* seglines : bscanSegmentations)
+		{
+			for(Segmentationlines::SegmentlineType type : usedLines)
+			{
+				const Segmentationlines::Segmentline& line = seglines->getSegmentLine(type);
+				writer.writeUInt32(static_cast<uint32_t>(line.size()));
+				writer.writeValues(line);
+			}
+		}
+
+		return data;
+	}
+
+	bool XOctSegmentationBin::read(const std::vector<char>& data, std::vector<Segmentationlines>& bscanSegmentations)
+	{
+		BinReader reader(data);
+
+		char fileMagic[sizeof(magic)];
+		if(!reader.readBytes(fileMagic, sizeof(fileMagic)) || std::memcmp(fileMagic, magic, sizeof(magic)) != 0)
+			return false;
+
+		uint32_t fileVersion = 0;
+		uint32_t valueSize   = 0;
+		uint32_t numBScans   = 0;
+		uint32_t numLines    = 0;
+		if(!reader.readUInt32(fileVersion) || fileVersion != version)
+			return false;
+		if(!reader.readUInt32(valueSize) || valueSize != sizeof(ValueType))
+			return false;
+		if(!reader.readUInt32(numBScans) || !reader.readUInt32(numLines))
+			return false;
+
+		// every line has at least its name length field, checked before the allocation
+		if(static_cast<uint64_t>(numLines)*sizeof(uint32_t) > reader.remaining())
+			return false;
+
+		std::vector<const Segmentationlines::SegmentlineType*> lineTypes(numLines);
+		for(const Segmentationlines::SegmentlineType*& lineType : lineTypes)
+		{
+			uint32_t nameLength = 0;
+			if(!reader.readUInt32(nameLength) || nameLength > reader.remaining())
+				return false;
+			std::string name(nameLength, '\0');
+			if(!reader.readBytes(&name[0], nameLength))
+				return false;
+			lineType = findSegmentlineType(name);
+		}
+
+		if(numLines == 0) // no segmentation in the series
+		{
+			bscanSegmentations.clear();
+			return true;
+		}
+
+		// every B-scan has at least the length fields, checked before the allocation
+		if(static_cast<uint64_t>(numBScans)*numLines*sizeof(uint32_t) > reader.remaining())
+			return false;
+
+		std::vector<Segmentationlines> result(numBScans);
+		for(Segmentationlines& seglines : result)
+		{
+			for(const Segmentationlines::SegmentlineType* lineType : lineTypes)
+			{
+				uint32_t numValues = 0;
+				if(!reader.readUInt32(numValues))
+					return false;
+				if(!reader.readValues(lineType ? &seglines.getSegmentLine(*lineType) : nullptr, numValues))
+					return false;
+			}
+		}
+
+		bscanSegmentations = std::move(result);
+		return true;
+	}
+}
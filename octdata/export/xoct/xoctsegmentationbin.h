@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <datastruct/segmentationlines.h>
+
+namespace OctData
+{
+	/**
+	 * binary segmentation entry of a xoct series (all B-scans in one zip entry, replaces the segmentation xml per B-scan)
+	 *
+	 * layout, all numbers little endian:
+	 *   char     magic[8]    "XOCTSEG\0"
+	 *   uint32   version     (1)
+	 *   uint32   valueSize   bytes per value (8: float64)
+	 *   uint32   numBScans
+	 *   uint32   numLines
+	 *   numLines times:                 uint32 nameLength, char name[nameLength] (Segmentationlines::getSegmentlineName)
+	 *   numBScans times numLines times: uint32 numValues , float64 values[numValues]
+	 */
+	class XOctSegmentationBin
+	{
+	public:
+		static std::vector<unsigned char> write(const std::vector<const Segmentationlines*>& bscanSegmentations);
+
+		// false for a broken or unsupported entry, line names unknown to this version are skipped
+		static bool read(const std::vector<char>& data, std::vector<Segmentationlines>& bscanSegmentations);
+
+		constexpr static const uint32_t version = 1;
+	};
+}
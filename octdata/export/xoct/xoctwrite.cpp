@@ -16,9 +16,13 @@
  */
 
 #include "xoctwrite.h"
+#include "xoctsegmentationbin.h"
 
 #include<fstream>
 #include<filesystem>
+#include<deque>
+#include<future>
+#include<memory>
 
 
 #include <boost/lexical_cast.hpp>
@@ -30,6 +34,7 @@
 #include <opencv2/opencv.hpp>
 
 #include <filewriteoptions.h>
+#include <threadpool.h>
 
 
 #include <datastruct/oct.h>
@@ -92,16 +97,102 @@ namespace OctData
 			return name.substr(namePos, name.size() - namePos);
 		}
 
+		void writeSegmentation(bpt::ptree& segNode, const Segmentationlines& seglines)
+		{
+			SetToPTree set(segNode);
+			for(OctData::Segmentationlines::SegmentlineType type : OctData::Segmentationlines::getSegmentlineTypes())
+			{
+				const Segmentationlines::Segmentline& seg = seglines.getSegmentLine(type);
+				if(!seg.empty())
+					set(Segmentationlines::getSegmentlineName(type), seg);
+			}
+		}
+
+		std::vector<uchar> serializeXml(const bpt::ptree& xmlTree)
+		{
+			std::stringstream stream;
+			bpt::write_xml(stream, xmlTree, bpt::xml_writer_make_settings<bpt::ptree::key_type>('\t', 1u));
+			const std::string xmlString = stream.str();
+			return std::vector<uchar>(xmlString.begin(), xmlString.end());
+		}
+
+		/**
+		 * the image encoding and xml serialisation run on the pool (opt.numThreads != 1),
+		 * the finished entries are added to the zip file by the calling thread in the order of the serial export
+		 */
 		class XOctWritter
 		{
+			enum class EntryType { image, xml, binary };
+
+			struct PendingEntry
+			{
+				std::string                     filename;
+				EntryType                       type;
+				std::future<std::vector<uchar>> data;
+			};
+
 			CppFW::ZipCpp& zipfile;
 			std::string imageExtention;
 			bool compressImage = false;
+			bool segmentationXml;
+
+			std::unique_ptr<ThreadPool> pool;
+			std::deque<PendingEntry>    pendingEntries;
+			std::size_t                 maxPendingEntries = 0; // limits the memory of encoded but not written entries
+
+			void addToZip(const std::string& filename, EntryType type, const std::vector<uchar>& data)
+			{
+				switch(type)
+				{
+					case EntryType::image:
+						zipfile.addFile(filename, data.data(), data.size(), compressImage);
+						break;
+					case EntryType::xml:
+					case EntryType::binary:
+						zipfile.addFile(filename, data.data(), static_cast<unsigned>(data.size()));
+						break;
+				}
+			}
+
+			void writeFirstPending()
+			{
+				PendingEntry& entry = pendingEntries.front();
+				addToZip(entry.filename, entry.type, entry.data.get());
+				pendingEntries.pop_front();
+			}
+
+			bool firstPendingReady() const
+			{
+				return !pendingEntries.empty()
+				    && pendingEntries.front().data.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+			}
+
+			template<typename Encoder>
+			void addEntry(const std::string& filename, EntryType type, Encoder&& encoder)
+			{
+				if(!pool)
+				{
+					addToZip(filename, type, encoder());
+					return;
+				}
+
+				pendingEntries.push_back(PendingEntry{filename, type, pool->submit(std::forward<Encoder>(encoder))});
+				while(pendingEntries.size() > maxPendingEntries || firstPendingReady())
+					writeFirstPending();
+			}
+
 		public:
 			XOctWritter(CppFW::ZipCpp& zipfile
 			          , const OctData::FileWriteOptions& opt)
 			: zipfile(zipfile)
+			, segmentationXml(opt.xoctSegmentationXml)
 			{
+				if(opt.numThreads != 1)
+				{
+					pool = std::make_unique<ThreadPool>(opt.numThreads);
+					maxPendingEntries = 4*pool->getNumThreads();
+				}
+
 				switch(opt.xoctImageFormat)
 				{
 					case FileWriteOptions::XoctImageFormat::png:
@@ -119,23 +210,31 @@ namespace OctData
 				}
 			}
 
+			// writes the pending entries, must be called before the zip file is closed
+			void flush()
+			{
+				while(!pendingEntries.empty())
+					writeFirstPending();
+			}
+
 			void writeImage(bpt::ptree& node, const cv::Mat& image, const std::string& filename, const std::string& imageName)
 			{
 				if(image.empty())
 					return;
 
-				std::vector<uchar> buffer;
-				cv::imencode(imageExtention, image, buffer);
-				zipfile.addFile(filename, buffer.data(), buffer.size(), compressImage);
+				const std::string extention = imageExtention;
+				addEntry(filename, EntryType::image, [image, extention]()
+					{
+						std::vector<uchar> buffer;
+						cv::imencode(extention, image, buffer);
+						return buffer;
+					});
 				node.add(imageName, filename);
 			}
 
-			void writeXml(const std::string& filename, bpt::ptree& xmlTree)
+			void writeXml(const std::string& filename, std::shared_ptr<const bpt::ptree> xmlTree)
 			{
-				std::stringstream stream;
-				bpt::write_xml(stream, xmlTree, bpt::xml_writer_make_settings<bpt::ptree::key_type>('\t', 1u));
-				std::string xmlString = stream.str();
-				zipfile.addFile(filename, xmlString.data(), static_cast<unsigned>(xmlString.size()));
+				addEntry(filename, EntryType::xml, [xmlTree]() { return serializeXml(*xmlTree); });
 			}
 
 
@@ -155,18 +254,6 @@ namespace OctData
 			}
 
 
-			void writeSegmentation(bpt::ptree& segNode, const Segmentationlines& seglines)
-			{
-				SetToPTree set(segNode);
-				for(OctData::Segmentationlines::SegmentlineType type : OctData::Segmentationlines::getSegmentlineTypes())
-				{
-					const Segmentationlines::Segmentline& seg = seglines.getSegmentLine(type);
-					if(!seg.empty())
-						set(Segmentationlines::getSegmentlineName(type), seg);
-				}
-			}
-
-
 			void writeBScan(bpt::ptree& seriesNode, const std::shared_ptr<const BScan>& bscan, std::size_t bscanNum, const std::string& dataPath)
 			{
 				if(!bscan)
@@ -180,14 +267,43 @@ namespace OctData
 				writeImage(bscanNode, bscan->getAngioImage(), dataPath + "bscanAngio_" + numString + imageExtention, "angioImage");
 
 
-				bpt::ptree seglinesTree;
-				writeSegmentation(seglinesTree.add("LayerSegmentation", ""), bscan->getSegmentLines());
+				if(!segmentationXml) // in the binary entry of the series
+					return;
 
+				// the segmentation lines are converted to text with the xml serialisation
 				std::string segmentationFile = dataPath + "segmentation_" + numString + ".xml";
-				writeXml(segmentationFile, seglinesTree);
+				addEntry(segmentationFile, EntryType::xml, [bscan]()
+					{
+						bpt::ptree seglinesTree;
+						writeSegmentation(seglinesTree.add("LayerSegmentation", ""), bscan->getSegmentLines());
+						return serializeXml(seglinesTree);
+					});
 				bscanNode.add("LayerSegmentationFile", segmentationFile);
 			}
 
+			// segmentation of all B-scans (in the order of the BScan nodes)
+			void writeSegmentationBin(bpt::ptree& seriesNode, const Series& series, const std::string& dataPath)
+			{
+				std::vector<std::shared_ptr<const BScan>> bscans;
+				for(const std::shared_ptr<const BScan>& bscan : series.getBScans())
+					if(bscan)
+						bscans.push_back(bscan);
+
+				if(bscans.empty())
+					return;
+
+				const std::string segmentationFile = dataPath + "segmentation.bin";
+				addEntry(segmentationFile, EntryType::binary, [bscans]()
+					{
+						std::vector<const Segmentationlines*> bscanSegmentations;
+						bscanSegmentations.reserve(bscans.size());
+						for(const std::shared_ptr<const BScan>& bscan : bscans)
+							bscanSegmentations.push_back(&bscan->getSegmentLines());
+						return XOctSegmentationBin::write(bscanSegmentations);
+					});
+				seriesNode.add("LayerSegmentationBinFile", segmentationFile);
+			}
+
 			template<typename S>
 			class SubStrutureFileWriter
 			{
@@ -203,7 +319,7 @@ namespace OctData
 					if(!writeFiles || !subTree || subTreeFilename.empty())
 						return;
 
-					parent.writeXml(subTreeFilename, *subTree);
+					parent.writeXml(subTreeFilename, std::move(subTree));
 				}
 
 			public:
@@ -279,6 +395,9 @@ namespace OctData
 			for(const std::shared_ptr<const BScan>& bscan : series.getBScans())
 				writeBScan(tree, bscan, bscanNum++, dataPath);
 
+			if(!segmentationXml)
+				writeSegmentationBin(tree, series, dataPath);
+
 			return true;
 		}
 	}
@@ -298,7 +417,8 @@ namespace OctData
 		if(!writter.writeStructure(octTree, dataPath, oct))
 			return false;
 
-		writter.writeXml("xoct.xml", xmlTree);
+		writter.writeXml("xoct.xml", std::make_shared<const bpt::ptree>(std::move(xmlTree)));
+		writter.flush();
 
 		return true;
 	}
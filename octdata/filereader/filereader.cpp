@@ -18,8 +18,10 @@
 #include "filereader.h"
 
 #include<boost/endian/conversion.hpp>
+#include<boost/log/trivial.hpp>
 
 #include"filestreamdircet.h"
+#include"filestreammmap.h"
 #include"filestreamgzip.h"
 #include <import/platform_helper.h>
 
@@ -56,7 +58,15 @@ namespace OctData
 		switch(compressType)
 		{
 			case Compressed::none:
-				fileStream = new FileStreamDircet(filepath);
+				try
+				{
+					fileStream = new FileStreamMMap(filepath);
+				}
+				catch(const std::exception& e)
+				{
+					BOOST_LOG_TRIVIAL(debug) << "Can't map file " << filepath << " (" << e.what() << "), use file stream";
+					fileStream = new FileStreamDircet(filepath);
+				}
 				break;
 			case Compressed::gzip:
 #ifdef WITH_ZLIB
@@ -67,6 +77,21 @@ namespace OctData
 		return fileStream != nullptr;
 	}
 
+	std::string FileReader::readPrefix(std::size_t size)
+	{
+		std::string prefix;
+		if(!fileStream && !openFile())
+			return prefix;
+
+		prefix.resize(size);
+		fileStream->seekg(0);
+		const std::streamsize readed = fileStream->read(prefix.data(), static_cast<std::streamsize>(size));
+		prefix.resize(readed > 0 ? static_cast<std::size_t>(readed) : 0);
+		fileStream->seekg(0);
+
+		return prefix;
+	}
+
 	std::size_t FileReader::file_size() const
 	{
 		if(filesize == 0)
@@ -77,15 +102,14 @@ namespace OctData
 					filesize = sfs::file_size(filepath);
 					break;
 				case Compressed::gzip:
-				{
-					std::ifstream stream(filepath, std::ios::binary | std::ios::in);
-					stream.seekg(-4, std::ios_base::end);
-					unsigned int size;
-					stream.read(reinterpret_cast<char*>(&size), sizeof(size));
-					boost::endian::little_to_native_inplace(size);
-					filesize = size;
+#ifdef WITH_ZLIB
+					// the open stream keeps the seek index built while inflating
+					if(fileStream)
+						filesize = static_cast<std::size_t>(static_cast<FileStreamGZip*>(fileStream)->uncompressedSize());
+					else
+						filesize = static_cast<std::size_t>(FileStreamGZip(filepath).uncompressedSize());
+#endif
 					break;
-				}
 			}
 		}
 
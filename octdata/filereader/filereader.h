@@ -28,6 +28,7 @@
 
 
 #include<iostream>
+#include<memory>
 
 namespace OctData
 {
@@ -41,6 +42,16 @@ namespace OctData
 		virtual void seekg(std::streamoff pos) = 0;
 
 		virtual bool good() const = 0;
+
+		// zero-copy access to the file content, nullptr if not supported by the stream (e.g. compressed files)
+		virtual const char* mapRegion(std::size_t /*offset*/, std::size_t /*size*/) { return nullptr; }
+		// size of the content available through mapRegion(), 0 if the stream is not mapped
+		virtual std::size_t mappedSize()                                    const { return 0; }
+		// keeps the memory returned by mapRegion() valid
+		virtual std::shared_ptr<const void> getMappingOwner()               const { return nullptr; }
+
+		// hint for the read-ahead of the operating system, the file is read from the beginning to the end
+		virtual void adviseSequential()                                           {}
 	};
 
 	class FileReader
@@ -56,6 +67,8 @@ namespace OctData
 
 		FileStreamInterface* fileStream = nullptr;
 
+		bool signatureMatch = false;
+
 		template<typename T>
 		void readFStreamBigInt(T* dest, std::size_t num, std::true_type)
 		{
@@ -86,10 +99,31 @@ namespace OctData
 
 
 		bool openFile();
+		// the first (up to) size bytes of the (uncompressed) file, opens the file if needed, the read position is 0 afterwards
+		std::string readPrefix(std::size_t size);
+
+		// set while the content matches the signature of the current reader, the extension check can be skipped
+		void setSignatureMatch(bool match)                             { signatureMatch = match; }
+		bool isSignatureMatch()                                  const { return signatureMatch; }
+
 		void seekg(std::streamoff pos)                                 { fileStream->seekg(pos); }
 		bool good()                                              const { return fileStream->good(); }
+		// uncompressed size, gzip files are inflated once (the size in the gzip trailer is modulo 4 GiB and only of the last member)
 		std::size_t file_size()                                  const;
 
+		// returns the number of bytes read
+		std::streamsize read(char* dest, std::streamsize size)         { return fileStream->read(dest, size); }
+		void adviseSequential()                                        { fileStream->adviseSequential(); }
+
+		/**
+		 * pointer to the file content [offset, offset+size) without copy, nullptr if the file is not mapped.
+		 * The memory is valid as long as this FileReader or the object from getMappingOwner() exists,
+		 * readers which keep images on mapped pages have to pass the owner to OCT::holdFileMapping()
+		 */
+		const char* mapRegion(std::size_t offset, std::size_t size)         { return fileStream->mapRegion(offset, size); }
+		std::size_t mappedSize()                                       const { return fileStream->mappedSize(); }
+		std::shared_ptr<const void> getMappingOwner()                  const { return fileStream->getMappingOwner(); }
+
 
 		template<typename T>
 		void readFStream(T* dest, std::size_t num = 1) { fileStream->read(reinterpret_cast<char*>(dest), sizeof(T)*num); }
@@ -114,5 +148,27 @@ namespace OctData
 			fileStream->read(reinterpret_cast<char*>(image.data), sizeof(T)*num);
 // 			stream.read(reinterpret_cast<char*>(image.data), num*sizeof(T));
 		}
+
+		/**
+		 * image header on the mapped file content at offset, falls back to readCVImage if the file is not mapped
+		 * returns true if the image data points to the mapping (see mapRegion)
+		 * the read position is behind the image in both cases
+		 */
+		template<typename T>
+		bool mapCVImage(cv::Mat& image, std::size_t offset, std::size_t sizeX, std::size_t sizeY)
+		{
+			const std::size_t num = sizeX*sizeY;
+			const char* region = mapRegion(offset, sizeof(T)*num);
+			if(region)
+			{
+				image = cv::Mat(static_cast<int>(sizeX), static_cast<int>(sizeY), cv::DataType<T>::type, const_cast<char*>(region));
+				fileStream->seekg(static_cast<std::streamoff>(offset + sizeof(T)*num));
+				return true;
+			}
+
+			fileStream->seekg(static_cast<std::streamoff>(offset));
+			readCVImage<T>(image, sizeX, sizeY);
+			return false;
+		}
 	};
 }
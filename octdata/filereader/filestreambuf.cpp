@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "filestreambuf.h"
+#include "filereader.h"
+
+#include<algorithm>
+#include<cstring>
+
+namespace OctData
+{
+	FileStreamBuf::FileStreamBuf(FileReader& filereader, std::size_t bufferSize)
+	: filereader(filereader)
+	{
+		filereader.adviseSequential();
+
+		// only mapped streams are asked for the size, for compressed files file_size() would inflate the whole file
+		const std::size_t size = filereader.mappedSize();
+		const char* region = size > 0 ? filereader.mapRegion(0, size) : nullptr;
+		if(region)
+		{
+			// the get area is the whole file, no reads and copies needed
+			char* data = const_cast<char*>(region);
+			setg(data, data, data + size);
+			mapped = true;
+			return;
+		}
+
+		buffer.resize(bufferSize > 0 ? bufferSize : defaultBufferSize);
+		filereader.seekg(0);
+		setg(buffer.data(), buffer.data(), buffer.data());
+	}
+
+	FileStreamBuf::int_type FileStreamBuf::underflow()
+	{
+		if(gptr() < egptr())
+			return traits_type::to_int_type(*gptr());
+		if(mapped)
+			return traits_type::eof();
+
+		// the read position of the filereader is behind the buffer
+		bufferOffset += static_cast<std::uint64_t>(egptr() - eback());
+		const std::streamsize readed = filereader.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		const std::size_t num = readed > 0 ? static_cast<std::size_t>(readed) : 0;
+		setg(buffer.data(), buffer.data(), buffer.data() + num);
+		if(num == 0)
+			return traits_type::eof();
+		return traits_type::to_int_type(*gptr());
+	}
+
+	std::streamsize FileStreamBuf::xsgetn(char* dest, std::streamsize count)
+	{
+		std::streamsize copied = 0;
+		while(copied < count)
+		{
+			const std::streamsize available = egptr() - gptr();
+			if(available > 0)
+			{
+				const std::streamsize num = std::min(available, count - copied);
+				std::memcpy(dest + copied, gptr(), static_cast<std::size_t>(num));
+				setg(eback(), gptr() + num, egptr()); // gbump takes an int, num can exceed it for mapped files
+				copied += num;
+				continue;
+			}
+
+			if(mapped)
+				break;
+
+			// big blocks directly into the destination
+			const std::streamsize remaining = count - copied;
+			if(static_cast<std::size_t>(remaining) >= buffer.size())
+			{
+				bufferOffset += static_cast<std::uint64_t>(egptr() - eback());
+				const std::streamsize readed = filereader.read(dest + copied, remaining);
+				const std::size_t num = readed > 0 ? static_cast<std::size_t>(readed) : 0;
+				bufferOffset += num;
+				setg(buffer.data(), buffer.data(), buffer.data());
+				copied += static_cast<std::streamsize>(num);
+				break;
+			}
+
+			if(traits_type::eq_int_type(underflow(), traits_type::eof()))
+				break;
+		}
+		return copied;
+	}
+
+	FileStreamBuf::pos_type FileStreamBuf::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+	{
+		const off_type current = static_cast<off_type>(bufferOffset) + (gptr() - eback());
+		switch(dir)
+		{
+			case std::ios_base::beg:
+				return seekpos(pos_type(off), which);
+			case std::ios_base::cur:
+				if(off == 0)
+					return pos_type(current); // tellg
+				return seekpos(pos_type(current + off), which);
+			case std::ios_base::end: // the file size is only needed here
+				return seekpos(pos_type(static_cast<off_type>(filereader.file_size()) + off), which);
+			default:
+				break;
+		}
+		return pos_type(off_type(-1));
+	}
+
+	FileStreamBuf::pos_type FileStreamBuf::seekpos(pos_type pos, std::ios_base::openmode which)
+	{
+		const off_type target = off_type(pos);
+		if(!(which & std::ios_base::in) || target < 0)
+			return pos_type(off_type(-1));
+
+		const std::uint64_t position = static_cast<std::uint64_t>(target);
+		const std::uint64_t bufferEnd = bufferOffset + static_cast<std::uint64_t>(egptr() - eback());
+		if(mapped)
+		{
+			if(position > bufferEnd)
+				return pos_type(off_type(-1));
+			setg(eback(), eback() + position, egptr());
+			return pos;
+		}
+
+		// inside of the buffer: no new read
+		if(position >= bufferOffset && position <= bufferEnd)
+		{
+			setg(eback(), eback() + (position - bufferOffset), egptr());
+			return pos;
+		}
+
+		filereader.seekg(static_cast<std::streamoff>(position));
+		bufferOffset = position;
+		setg(buffer.data(), buffer.data(), buffer.data());
+		return pos;
+	}
+}
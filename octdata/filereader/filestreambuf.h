@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include<cstdint>
+#include<streambuf>
+#include<vector>
+
+namespace OctData
+{
+	class FileReader;
+
+	/**
+	 * std::streambuf over a FileReader for the parsers with many small reads (std::istream interface),
+	 * mapped files are used without copy, else the data is read in blocks of bufferSize bytes.
+	 * The FileReader has to be opened and must not be used by others while the FileStreamBuf is in use
+	 */
+	class FileStreamBuf : public std::streambuf
+	{
+		FileReader&       filereader;
+		std::vector<char> buffer;
+		std::uint64_t     bufferOffset = 0; // file position of eback()
+		bool              mapped       = false;
+
+	protected:
+		virtual int_type        underflow()                                                                        override;
+		virtual std::streamsize xsgetn(char* dest, std::streamsize count)                                          override;
+		virtual pos_type        seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)  override;
+		virtual pos_type        seekpos(pos_type pos, std::ios_base::openmode which)                               override;
+
+	public:
+		static const std::size_t defaultBufferSize = 256*1024;
+
+		// bufferSize 0: defaultBufferSize
+		explicit FileStreamBuf(FileReader& filereader, std::size_t bufferSize = 0);
+
+		FileStreamBuf(const FileStreamBuf&)            = delete;
+		FileStreamBuf& operator=(const FileStreamBuf&) = delete;
+	};
+}
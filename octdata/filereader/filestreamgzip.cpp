@@ -20,19 +20,282 @@
 
 #ifdef WITH_ZLIB
 
+#include<algorithm>
+#include<cstring>
+
+#include<boost/log/trivial.hpp>
+
 namespace OctData
 {
+	namespace
+	{
+		const int gzipWindowBits = 15 + 32; // gzip or zlib header, detected by zlib
+		const int rawWindowBits  = -15;
+	}
 
 	FileStreamGZip::FileStreamGZip(const std::filesystem::path& filepath)
+	: input    (filepath, std::ios::binary | std::ios::in)
+	, inBuffer (chunkSize)
+	, outBuffer(windowSize + chunkSize)
 	{
-		file = gzopen(filepath.generic_string().c_str(), "r");
-		gzbuffer(file, 128*1024);
+		std::memset(&strm, 0, sizeof(strm));
+		if(!input.good() || inflateInit2(&strm, gzipWindowBits) != Z_OK)
+		{
+			BOOST_LOG_TRIVIAL(error) << "Can't open gzip file " << filepath.generic_string();
+			error = true;
+			return;
+		}
+		zstreamInit = true;
 	}
 
 	FileStreamGZip::~FileStreamGZip()
 	{
-		gzclose(file);
-	};
+		if(zstreamInit)
+			inflateEnd(&strm);
+	}
+
+
+	bool FileStreamGZip::fillInput()
+	{
+		if(strm.avail_in > 0)
+			return true;
+
+		input.read(reinterpret_cast<char*>(inBuffer.data()), static_cast<std::streamsize>(inBuffer.size()));
+		const std::streamsize readed = input.gcount();
+		strm.next_in  = inBuffer.data();
+		strm.avail_in = static_cast<uInt>(readed > 0 ? readed : 0);
+		return strm.avail_in > 0;
+	}
+
+	bool FileStreamGZip::skipInput(std::size_t num)
+	{
+		while(num > 0)
+		{
+			if(!fillInput())
+				return false;
+			const std::size_t skipped = std::min(num, static_cast<std::size_t>(strm.avail_in));
+			strm.next_in  += skipped;
+			strm.avail_in -= static_cast<uInt>(skipped);
+			totalIn       += skipped;
+			num           -= skipped;
+		}
+		return true;
+	}
+
+	void FileStreamGZip::addCheckpoint()
+	{
+		Checkpoint checkpoint;
+		checkpoint.out  = totalOut;
+		checkpoint.in   = totalIn;
+		checkpoint.bits = strm.data_type & 7;
+
+		// outBuffer holds at least the last 32 KiB of output (or all output)
+		const std::size_t windowFill = std::min(outEnd, windowSize);
+		checkpoint.window.assign(outBuffer.data() + outEnd - windowFill, outBuffer.data() + outEnd);
+
+		index.push_back(std::move(checkpoint));
+	}
+
+	/**
+	 * inflates the next part of the file behind outEnd, only called if all buffered data is consumed
+	 * returns false at the end of the data
+	 */
+	bool FileStreamGZip::inflateChunk()
+	{
+		if(streamEnd || error)
+			return false;
+
+		// keep the last 32 KiB as dictionary for the checkpoints
+		if(outBuffer.size() - outEnd < chunkSize/2)
+		{
+			const std::size_t keep = std::min(outEnd, windowSize);
+			std::memmove(outBuffer.data(), outBuffer.data() + outEnd - keep, keep);
+			outPos = keep;
+			outEnd = keep;
+		}
+
+		for(;;)
+		{
+			if(!fillInput())
+			{
+				if(!memberStart)
+					BOOST_LOG_TRIVIAL(warning) << "gzip file truncated";
+				streamEnd = true;
+				return false;
+			}
+
+			const uInt availIn = strm.avail_in;
+			strm.next_out  = outBuffer.data() + outEnd;
+			strm.avail_out = static_cast<uInt>(outBuffer.size() - outEnd);
+			const int ret = inflate(&strm, Z_BLOCK);
+
+			const std::size_t produced = outBuffer.size() - outEnd - strm.avail_out;
+			totalIn  += availIn - strm.avail_in;
+			totalOut += produced;
+			outEnd   += produced;
+			if(produced > 0)
+				memberStart = false;
+
+			if(ret == Z_NEED_DICT || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR || ret == Z_STREAM_ERROR)
+			{
+				// data behind a complete member (e.g. zero padding) is ignored like gzread does
+				if(!memberStart)
+				{
+					BOOST_LOG_TRIVIAL(error) << "gzip inflate error: " << (strm.msg ? strm.msg : "");
+					error = true;
+				}
+				streamEnd = true;
+				return produced > 0;
+			}
+
+			if(ret == Z_STREAM_END)
+			{
+				// the trailer (crc32, size) of a member is only handled by zlib for streams with header
+				if(rawMode && !skipInput(8))
+				{
+					streamEnd = true;
+					return produced > 0;
+				}
+
+				memberStart = true;
+				rawMode     = false;
+				inflateReset2(&strm, gzipWindowBits);
+			}
+			else if((strm.data_type & 128) && !(strm.data_type & 64) && !memberStart)
+			{
+				// end of a block (or the header): restart point, the index is only extended behind the last checkpoint
+				if(index.empty() || totalOut >= index.back().out + indexSpan)
+					addCheckpoint();
+			}
+
+			if(produced > 0)
+				return true;
+		}
+	}
+
+	void FileStreamGZip::restart(const Checkpoint* checkpoint)
+	{
+		input.clear();
+		strm.next_in  = nullptr;
+		strm.avail_in = 0;
+		streamEnd     = false;
+		memberStart   = false;
+
+		if(!checkpoint)
+		{
+			input.seekg(0);
+			inflateReset2(&strm, gzipWindowBits);
+			rawMode  = false;
+			totalIn  = 0;
+			totalOut = 0;
+			outPos   = 0;
+			outEnd   = 0;
+			return;
+		}
+
+		inflateReset2(&strm, rawWindowBits);
+		rawMode = true;
+
+		if(checkpoint->bits > 0)
+		{
+			// the first bits of the block are in the byte before checkpoint->in
+			input.seekg(static_cast<std::streamoff>(checkpoint->in - 1));
+			const int byte = input.get();
+			if(byte == std::char_traits<char>::eof())
+			{
+				error = true;
+				return;
+			}
+			inflatePrime(&strm, checkpoint->bits, byte >> (8 - checkpoint->bits));
+		}
+		else
+			input.seekg(static_cast<std::streamoff>(checkpoint->in));
+
+		inflateSetDictionary(&strm, checkpoint->window.data(), static_cast<uInt>(checkpoint->window.size()));
+
+		std::copy(checkpoint->window.begin(), checkpoint->window.end(), outBuffer.begin());
+		outPos   = checkpoint->window.size();
+		outEnd   = checkpoint->window.size();
+		totalIn  = checkpoint->in;
+		totalOut = checkpoint->out;
+	}
+
+	void FileStreamGZip::skip(std::uint64_t num)
+	{
+		while(num > 0)
+		{
+			if(outPos == outEnd && !inflateChunk())
+				return;
+			const std::size_t skipped = static_cast<std::size_t>(std::min<std::uint64_t>(num, outEnd - outPos));
+			outPos += skipped;
+			num    -= skipped;
+		}
+	}
+
+
+	std::uint64_t FileStreamGZip::uncompressedSize()
+	{
+		if(dataSizeKnown || !zstreamInit)
+			return dataSize;
+
+		// the trailer of the last member can't be used, it has only the size of this member (modulo 4 GiB)
+		const std::uint64_t pos = position();
+		outPos = outEnd;
+		while(inflateChunk())
+			outPos = outEnd;
+		dataSize = totalOut;
+		seekg(static_cast<std::streamoff>(pos));
+
+		dataSizeKnown = true;
+		return dataSize;
+	}
+
+
+	std::streamsize FileStreamGZip::read(char* dest, std::streamsize size)
+	{
+		std::streamsize readed = 0;
+		while(readed < size)
+		{
+			if(outPos == outEnd && !inflateChunk())
+			{
+				eof = true;
+				break;
+			}
+
+			const std::size_t num = std::min(static_cast<std::size_t>(size - readed), outEnd - outPos);
+			std::memcpy(dest + readed, outBuffer.data() + outPos, num);
+			outPos += num;
+			readed += static_cast<std::streamsize>(num);
+		}
+		return readed;
+	}
+
+	void FileStreamGZip::seekg(std::streamoff pos)
+	{
+		if(!zstreamInit || pos < 0)
+			return;
+
+		eof = false;
+		const std::uint64_t target = static_cast<std::uint64_t>(pos);
+
+		// still in the buffer (also the dictionary part)
+		if(target <= totalOut && totalOut - target <= outEnd)
+		{
+			outPos = outEnd - static_cast<std::size_t>(totalOut - target);
+			return;
+		}
+
+		// nearest checkpoint before the target
+		std::vector<Checkpoint>::const_iterator it = std::upper_bound(index.cbegin(), index.cend(), target, [](std::uint64_t value, const Checkpoint& cp) { return value < cp.out; });
+		const Checkpoint* checkpoint = it == index.cbegin() ? nullptr : &*(it - 1);
+		const std::uint64_t checkpointOut = checkpoint ? checkpoint->out : 0;
+
+		// forward from the current position if no checkpoint is nearer
+		if(target < position() || checkpointOut > totalOut)
+			restart(checkpoint);
+
+		skip(target - position());
+	}
 
 }
 
@@ -20,24 +20,83 @@
 #ifdef WITH_ZLIB
 
 #include "filereader.h"
+
+#include<cstdint>
+#include<fstream>
+#include<vector>
+
 #include <zlib.h>
 
 
 namespace OctData
 {
-
+	/**
+	 * gzip stream with random access: while inflating, a checkpoint (position in the compressed data and the last 32 KiB
+	 * of output as dictionary) is stored roughly every indexSpan bytes at a deflate block boundary. A seek restarts from the
+	 * nearest checkpoint instead of inflating the file again from the beginning (see zran.c of zlib).
+	 * Files with several gzip members (e.g. from pigz or concatenated files) are read completely.
+	 */
 	class FileStreamGZip : public FileStreamInterface
 	{
-		gzFile file;
+		struct Checkpoint
+		{
+			std::uint64_t              out  = 0; // position in the uncompressed data
+			std::uint64_t              in   = 0; // first complete byte of the compressed data
+			int                        bits = 0; // bits of the byte before in which belong to the block
+			std::vector<unsigned char> window;
+		};
+
+		static const std::size_t windowSize = 32*1024;
+		static const std::size_t chunkSize  = 256*1024;
+		static const std::size_t indexSpan  = 1024*1024;
+
+		std::ifstream              input;
+		z_stream                   strm;
+		bool                       zstreamInit = false;
+		bool                       rawMode     = false; // restarted in a checkpoint, no gzip header and trailer handling by zlib
+		bool                       memberStart = false; // behind the end of a gzip member, garbage is not an error
+		bool                       streamEnd   = false;
+		bool                       eof         = false;
+		bool                       error       = false;
+
+		std::vector<unsigned char> inBuffer;
+		std::vector<unsigned char> outBuffer;   // [0, outEnd) is the uncompressed data [totalOut - outEnd, totalOut)
+		std::size_t                outPos   = 0;
+		std::size_t                outEnd   = 0;
+		std::uint64_t              totalOut = 0;
+		std::uint64_t              totalIn  = 0;
+
+		std::vector<Checkpoint>    index;
+
+		std::uint64_t              dataSize      = 0;
+		bool                       dataSizeKnown = false;
+
+		bool fillInput();
+		bool inflateChunk();
+		bool skipInput(std::size_t num);
+		void addCheckpoint();
+		void restart(const Checkpoint* checkpoint);
+		void skip(std::uint64_t num);
+
+		std::uint64_t position()                                 const { return totalOut - (outEnd - outPos); }
+
 	public:
 		FileStreamGZip(const std::filesystem::path& filepath);
 		virtual ~FileStreamGZip();
 
+		FileStreamGZip(const FileStreamGZip&)            = delete;
+		FileStreamGZip& operator=(const FileStreamGZip&) = delete;
+
+
+		virtual std::streamsize read(char* dest, std::streamsize size) override;
+		virtual void seekg(std::streamoff pos)                override;
+		virtual bool good()                             const override { return !eof && !error; }
 
-		virtual std::streamsize read(char* dest, std::streamsize size) override
-		                                                               { return gzread(file, dest, static_cast<unsigned>(size)); }
-		virtual void seekg(std::streamoff pos)                override { gzseek(file, pos, SEEK_SET); }
-		virtual bool good()                             const override { return !gzeof(file); }
+		/**
+		 * size of the uncompressed data, the file is inflated once (the index is built on the way),
+		 * the trailer holds only the size modulo 4 GiB of the last member
+		 */
+		std::uint64_t uncompressedSize();
 	};
 
 }
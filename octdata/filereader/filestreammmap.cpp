@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "filestreammmap.h"
+
+#include<cstring>
+
+#include<boost/interprocess/file_mapping.hpp>
+#include<boost/interprocess/mapped_region.hpp>
+
+#include<boost/log/trivial.hpp>
+
+namespace bip = boost::interprocess;
+
+namespace OctData
+{
+	class FileStreamMMap::Mapping
+	{
+	public:
+		bip::file_mapping  file;
+		bip::mapped_region region;
+
+		Mapping(const std::filesystem::path& filepath)
+		: file  (filepath.string().c_str(), bip::read_only)
+		, region(file, bip::copy_on_write)
+		{}
+	};
+
+
+	FileStreamMMap::FileStreamMMap(const std::filesystem::path& filepath)
+	: mapping(std::make_shared<Mapping>(filepath))
+	{
+		data = static_cast<const char*>(mapping->region.get_address());
+		size = mapping->region.get_size();
+		BOOST_LOG_TRIVIAL(trace) << "mapped file " << filepath << " (" << size << " bytes)";
+	}
+
+	FileStreamMMap::~FileStreamMMap()
+	{
+	}
+
+
+	std::streamsize FileStreamMMap::read(char* dest, std::streamsize readSize)
+	{
+		std::size_t num = static_cast<std::size_t>(readSize);
+		if(pos >= size)
+		{
+			eof = true;
+			return 0;
+		}
+		if(num > size - pos)
+		{
+			num = size - pos;
+			eof = true;
+		}
+
+		std::memcpy(dest, data + pos, num);
+		pos += num;
+		return static_cast<std::streamsize>(num);
+	}
+
+	const char* FileStreamMMap::mapRegion(std::size_t offset, std::size_t regionSize)
+	{
+		if(offset > size || regionSize > size - offset)
+			return nullptr;
+		return data + offset;
+	}
+
+	std::shared_ptr<const void> FileStreamMMap::getMappingOwner() const
+	{
+		return mapping;
+	}
+
+	void FileStreamMMap::adviseSequential()
+	{
+		if(!mapping->region.advise(bip::mapped_region::advice_sequential))
+			BOOST_LOG_TRIVIAL(trace) << "madvise sequential not supported";
+	}
+
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "filereader.h"
+
+#include <memory>
+
+namespace OctData
+{
+
+	/**
+	 * memory mapped file, the mapping is shared with all regions returned by mapRegion()
+	 * and stays valid as long as the owner from getMappingOwner() is alive
+	 */
+	class FileStreamMMap : public FileStreamInterface
+	{
+		class Mapping;
+		std::shared_ptr<Mapping> mapping;
+
+		const char* data = nullptr;
+		std::size_t size = 0;
+		std::size_t pos  = 0;
+		bool        eof  = false;
+
+	public:
+		FileStreamMMap(const std::filesystem::path& filepath);
+		virtual ~FileStreamMMap();
+
+		virtual std::streamsize read(char* dest, std::streamsize size) override;
+		virtual void seekg(std::streamoff pos)                override { this->pos = static_cast<std::size_t>(pos); eof = false; }
+		virtual bool good()                             const override { return !eof; }
+
+		virtual const char* mapRegion(std::size_t offset, std::size_t size) override;
+		virtual std::size_t mappedSize()                              const override { return size; }
+		virtual std::shared_ptr<const void> getMappingOwner()     const override;
+
+		virtual void adviseSequential()                             override;
+	};
+
+}
@@ -19,10 +19,47 @@
 
 #include<string>
 #include<vector>
+#include<algorithm>
 #include"datastruct/objectwrapper.h"
+#include"datastruct/date.h"
 
 namespace OctData
 {
+	// selection of the series and B-scans to read (E2E, sdb), every empty criterion accepts all
+	class SeriesSelection
+	{
+		static int dayNumber(const Date& date)                         { return (date.year()*100 + date.month())*100 + date.day(); }
+
+		template<typename T>
+		static bool inList(const std::vector<T>& list, const T& value) { return list.empty() || std::find(list.begin(), list.end(), value) != list.end(); }
+
+	public:
+		std::vector<std::string> seriesUIDs;
+		std::vector<int>         seriesIds;       // internal id of the series in the file
+		std::vector<std::string> scanPatterns;    // name of Series::ScanPattern (e.g. "Volume") or the scan pattern text
+		Date                     firstDate;       // first and last accepted day of the study (inclusive), a series without date is rejected
+		Date                     lastDate;
+		int                      bscanBegin = 0;  // B-scans [bscanBegin, bscanEnd) of every series
+		int                      bscanEnd   = -1; // -1: up to the last B-scan
+
+		bool selectsAllSeries()                                  const { return seriesUIDs.empty() && seriesIds.empty() && scanPatterns.empty() && firstDate.isEmpty() && lastDate.isEmpty(); }
+
+		bool acceptSeriesUID(const std::string& uid)             const { return inList(seriesUIDs, uid); }
+		bool acceptSeriesId (int id)                             const { return inList(seriesIds , id ); }
+		bool acceptScanPattern(const std::string& name, const std::string& text) const
+		                                                               { return scanPatterns.empty() || (!name.empty() && inList(scanPatterns, name)) || (!text.empty() && inList(scanPatterns, text)); }
+		bool acceptDate(const Date& date)                        const
+		{
+			if(firstDate.isEmpty() && lastDate.isEmpty())
+				return true;
+			if(date.isEmpty())
+				return false;
+			return (firstDate.isEmpty() || dayNumber(firstDate) <= dayNumber(date))
+			    && (lastDate .isEmpty() || dayNumber(date) <= dayNumber(lastDate));
+		}
+		bool acceptBScan(std::size_t index)                      const { return index >= static_cast<std::size_t>(std::max(bscanBegin, 0)) && (bscanEnd < 0 || index < static_cast<std::size_t>(bscanEnd)); }
+	};
+
 	class FileReadOptions
 	{
 	public:
@@ -36,10 +73,17 @@ namespace OctData
 		bool holdRawData         = false;
 		bool loadRefFiles        = true;
 		bool readBScans          = true;
+		bool readSlo             = true;
 
 		bool dumpFileParts       = false;
 		
 		int readBScanNum         = -1;
+
+		bool lazyBScans          = false; // load the B-scan images on the first access (vol, octbin with series files)
+		int  bscanCacheSize      = 0;     // max. loaded images per series with lazyBScans, 0: no limit (not used for octbin series files)
+
+		int  numThreads          = 0;     // worker threads for the conversion and decoding, 0: number of cores, 1: no extra threads
+		int  readBufferSize      = 0;     // read-ahead buffer in bytes of the stream parsers (topcon, Bioptigen) for not mapped files, 0: default
 		
 		std::vector<int> xorTest;
 
@@ -47,6 +91,10 @@ namespace OctData
 
 		std::string libPath;
 
+		// not part of getSetParameter, the selection only skips the conversion:
+		// libE2E still decodes all series and B-scans of the file and for sdb all pdb/edb files are loaded
+		SeriesSelection seriesSelection;
+
 		template<typename T> void getSetParameter(T& getSet)           { getSetParameter(getSet, *this); }
 		template<typename T> void getSetParameter(T& getSet)     const { getSetParameter(getSet, *this); }
 
@@ -62,7 +110,12 @@ namespace OctData
 			getSet("holdRawData"        , p.holdRawData                            );
 			getSet("loadRefFiles"       , p.loadRefFiles                           );
 			getSet("readBScans"         , p.readBScans                             );
+			getSet("readSlo"            , p.readSlo                                );
 			getSet("readBScanNum"       , p.readBScanNum                           );
+			getSet("numThreads"         , p.numThreads                             );
+			getSet("lazyBScans"         , p.lazyBScans                             );
+			getSet("bscanCacheSize"     , p.bscanCacheSize                         );
+			getSet("readBufferSize"     , p.readBufferSize                         );
 			getSet("e2eGrayTransform"   , static_cast<std::string&>(e2eGrayWrapper));
 			
 			
@@ -31,7 +31,10 @@ namespace OctData
 
 
 		bool            octBinFlat      = false;
+		bool            octBinSeriesFiles = false; // octbin (not flat): B-scan images of every series in an own file, the main file holds the structure and the index of these files
 		XoctImageFormat xoctImageFormat = XoctImageFormat::png;
+		bool            xoctSegmentationXml = false; // xoct segmentation as xml file per B-scan (readable by old versions) instead of one binary entry per series
+		int             numThreads      = 0;     // threads for the image encoding (xoct), 0: number of cores, 1: no extra threads
 
 
 		template<typename T> void getSetParameter(T& getSet)           { getSetParameter(getSet, *this); }
@@ -44,7 +47,10 @@ namespace OctData
 			XoctImageFormatEnumWrapper xoctImageFormat(p.xoctImageFormat);
 
 			getSet("octBinFlat"     , p.octBinFlat                              );
+			getSet("octBinSeriesFiles", p.octBinSeriesFiles                     );
 			getSet("xoctImageFormat", static_cast<std::string&>(xoctImageFormat));
+			getSet("xoctSegmentationXml", p.xoctSegmentationXml                 );
+			getSet("numThreads"     , p.numThreads                              );
 		}
 	};
 }
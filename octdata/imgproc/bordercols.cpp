@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bordercols.h"
+#include "cpufeatures.h"
+#include "lut16to8.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <opencv2/opencv.hpp>
+
+#ifdef OCTDATA_X86
+	#include <immintrin.h>
+#endif
+
+namespace OctData
+{
+	namespace
+	{
+		// the SIMD versions skip whole blocks which are equal to value and return the number of the skipped bytes,
+		// the exact position in the block with the difference is searched by the scalar version
+
+		std::size_t findFirstNotEqualScalar(const uint8_t* data, std::size_t begin, std::size_t num, uint8_t value)
+		{
+			for(std::size_t i = begin; i < num; ++i)
+				if(data[i] != value)
+					return i;
+			return num;
+		}
+
+		// reverse search in data[0, end), num if all bytes are equal to value
+		std::size_t findLastNotEqualScalar(const uint8_t* data, std::size_t end, std::size_t num, uint8_t value)
+		{
+			for(std::size_t i = end; i > 0; --i)
+				if(data[i-1] != value)
+					return i-1;
+			return num;
+		}
+
+#ifdef OCTDATA_X86
+		OCTDATA_TARGET_AVX2 std::size_t skipEqualForwardAVX2(const uint8_t* data, std::size_t num, uint8_t value)
+		{
+			const __m256i ref = _mm256_set1_epi8(static_cast<char>(value));
+
+			std::size_t i = 0;
+			for(; i + 32 <= num; i += 32)
+			{
+				const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+				if(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, ref)) != -1)
+					break;
+			}
+			return i;
+		}
+
+		OCTDATA_TARGET_AVX2 std::size_t skipEqualBackwardAVX2(const uint8_t* data, std::size_t num, uint8_t value)
+		{
+			const __m256i ref = _mm256_set1_epi8(static_cast<char>(value));
+
+			std::size_t i = 0;
+			for(; i + 32 <= num; i += 32)
+			{
+				const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + num - i - 32));
+				if(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, ref)) != -1)
+					break;
+			}
+			return i;
+		}
+
+		OCTDATA_TARGET_AVX512 std::size_t skipEqualForwardAVX512(const uint8_t* data, std::size_t num, uint8_t value)
+		{
+			const __m512i ref = _mm512_set1_epi8(static_cast<char>(value));
+
+			std::size_t i = 0;
+			for(; i + 64 <= num; i += 64)
+			{
+				const __m512i v = _mm512_loadu_si512(data + i);
+				if(_mm512_cmpneq_epi8_mask(v, ref) != 0)
+					break;
+			}
+			return i;
+		}
+
+		OCTDATA_TARGET_AVX512 std::size_t skipEqualBackwardAVX512(const uint8_t* data, std::size_t num, uint8_t value)
+		{
+			const __m512i ref = _mm512_set1_epi8(static_cast<char>(value));
+
+			std::size_t i = 0;
+			for(; i + 64 <= num; i += 64)
+			{
+				const __m512i v = _mm512_loadu_si512(data + num - i - 64);
+				if(_mm512_cmpneq_epi8_mask(v, ref) != 0)
+					break;
+			}
+			return i;
+		}
+#endif
+
+		// left border: columns [0, leftEnd), right border: columns [rightBegin, cols)
+		struct BorderCols
+		{
+			std::size_t leftEnd    = 0;
+			std::size_t rightBegin = 0;
+			std::size_t cols       = 0;
+
+			explicit BorderCols(std::size_t numCols) : leftEnd(numCols), rightBegin(0), cols(numCols) {}
+
+			// only the parts of the row outside of the content found so far are scanned
+			void addRow(const uint8_t* row, uint8_t borderValue)
+			{
+				if(leftEnd > 0)
+					leftEnd = findFirstNotEqual(row, leftEnd, borderValue);
+
+				if(rightBegin < cols)
+				{
+					const std::size_t scanBegin = std::max(rightBegin, leftEnd);
+					const std::size_t last      = findLastNotEqual(row + scanBegin, cols - scanBegin, borderValue);
+					if(last < cols - scanBegin)
+						rightBegin = scanBegin + last + 1;
+				}
+			}
+
+			void fill(cv::Mat& image, uint8_t fillValue) const
+			{
+				if(leftEnd == cols) // no content
+				{
+					image.setTo(cv::Scalar(fillValue));
+					return;
+				}
+
+				if(leftEnd == 0 && rightBegin == cols)
+					return;
+
+				for(int row = 0; row < image.rows; ++row)
+				{
+					uint8_t* rowPtr = image.ptr<uint8_t>(row);
+					std::memset(rowPtr, fillValue, leftEnd);
+					std::memset(rowPtr + rightBegin, fillValue, cols - rightBegin);
+				}
+			}
+		};
+	}
+
+
+	std::size_t findFirstNotEqual(const uint8_t* data, std::size_t num, uint8_t value)
+	{
+		std::size_t done = 0;
+#ifdef OCTDATA_X86
+		const CpuFeatures& cpu = CpuFeatures::getInstance();
+		if(cpu.hasAVX512())
+			done = skipEqualForwardAVX512(data, num, value);
+		else if(cpu.hasAVX2())
+			done = skipEqualForwardAVX2(data, num, value);
+#endif
+		return findFirstNotEqualScalar(data, done, num, value);
+	}
+
+	std::size_t findLastNotEqual(const uint8_t* data, std::size_t num, uint8_t value)
+	{
+		std::size_t done = 0;
+#ifdef OCTDATA_X86
+		const CpuFeatures& cpu = CpuFeatures::getInstance();
+		if(cpu.hasAVX512())
+			done = skipEqualBackwardAVX512(data, num, value);
+		else if(cpu.hasAVX2())
+			done = skipEqualBackwardAVX2(data, num, value);
+#endif
+		return findLastNotEqualScalar(data, num - done, num, value);
+	}
+
+	void fillEmptyBorderCols(cv::Mat& image, uint8_t borderValue, uint8_t fillValue)
+	{
+		BorderCols border(static_cast<std::size_t>(image.cols));
+		for(int row = 0; row < image.rows; ++row)
+			border.addRow(image.ptr<uint8_t>(row), borderValue);
+		border.fill(image, fillValue);
+	}
+
+	void lut16To8FillBorderCols(const cv::Mat& src, cv::Mat& dest, const uint8_t* lut, uint8_t borderValue, uint8_t fillValue)
+	{
+		dest.create(src.rows, src.cols, cv::DataType<uint8_t>::type);
+
+		BorderCols border(static_cast<std::size_t>(src.cols));
+		for(int row = 0; row < src.rows; ++row)
+		{
+			uint8_t* destRow = dest.ptr<uint8_t>(row);
+			lut16To8(src.ptr<uint16_t>(row), destRow, border.cols, lut);
+			border.addRow(destRow, borderValue);
+		}
+		border.fill(dest, fillValue);
+	}
+}
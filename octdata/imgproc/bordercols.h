@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cv { class Mat; }
+
+namespace OctData
+{
+	// index of the first byte != value, num if all bytes are equal to value
+	std::size_t findFirstNotEqual(const uint8_t* data, std::size_t num, uint8_t value);
+
+	// index of the last byte != value, num if all bytes are equal to value
+	std::size_t findLastNotEqual(const uint8_t* data, std::size_t num, uint8_t value);
+
+	/**
+	 * columns at the left and right side, which are borderValue in every row, are set to fillValue (CV_8UC1)
+	 * an image without other values is completely set to fillValue
+	 */
+	void fillEmptyBorderCols(cv::Mat& image, uint8_t borderValue, uint8_t fillValue);
+
+	// lut16To8 followed by fillEmptyBorderCols, the border is detected while the converted row is in the cache
+	void lut16To8FillBorderCols(const cv::Mat& src, cv::Mat& dest, const uint8_t* lut, uint8_t borderValue, uint8_t fillValue);
+}
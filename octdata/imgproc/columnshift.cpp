@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "columnshift.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+namespace OctData
+{
+	namespace
+	{
+		const int interBits  = 5;
+		const int interScale = 1 << interBits;
+
+		// columns [begin, end) of the destination read the rows y+rowOffset and y+rowOffset+1 of the source
+		struct ColumnRun
+		{
+			int begin     = 0;
+			int end       = 0;
+			int rowOffset = 0;
+		};
+
+		void columnShiftUInt8(const cv::Mat& src, cv::Mat& dest, const ColumnShift& shift, uint8_t fillValue, bool linear)
+		{
+			const int rows = src.rows;
+			const int cols = src.cols;
+
+			dest.create(rows, cols, cv::DataType<uint8_t>::type);
+			dest.setTo(cv::Scalar(fillValue));
+
+			const int destBegin = std::max(0, shift.shiftX);
+			const int destEnd   = std::min(cols, cols + shift.shiftX);
+			if(destBegin >= destEnd || rows == 0)
+				return;
+
+			// per destination column: source row offset and weight of the second row, columns with the same offset are contiguous
+			std::vector<uint16_t>  weights(static_cast<std::size_t>(cols), 0);
+			std::vector<ColumnRun> runs;
+			for(int col = destBegin; col < destEnd; ++col)
+			{
+				const double sourceRow = -shift.getShiftY(col - shift.shiftX); // source row of the destination row 0
+				int rowOffset = static_cast<int>(std::floor(sourceRow));
+				int weight    = static_cast<int>(std::lround((sourceRow - rowOffset)*interScale));
+				if(!linear)
+					weight = sourceRow - rowOffset >= 0.5 ? interScale : 0;
+				if(weight == interScale)
+				{
+					++rowOffset;
+					weight = 0;
+				}
+				weights[static_cast<std::size_t>(col)] = static_cast<uint16_t>(weight);
+
+				if(runs.empty() || runs.back().rowOffset != rowOffset)
+				{
+					ColumnRun run;
+					run.begin     = col;
+					run.rowOffset = rowOffset;
+					runs.push_back(run);
+				}
+				runs.back().end = col + 1;
+			}
+
+			// rows outside of the source are read from a row with the fill value
+			const std::vector<uint8_t> fillRow(static_cast<std::size_t>(cols), fillValue);
+			auto sourceRow = [&](int row, int sourceColBegin) -> const uint8_t*
+			{
+				if(row < 0 || row >= rows)
+					return fillRow.data() + sourceColBegin;
+				return src.ptr<uint8_t>(row) + sourceColBegin;
+			};
+
+			for(int row = 0; row < rows; ++row)
+			{
+				uint8_t* destRow = dest.ptr<uint8_t>(row);
+				for(const ColumnRun& run : runs)
+				{
+					const int       sourceColBegin = run.begin - shift.shiftX;
+					const uint8_t*  row0    = sourceRow(row + run.rowOffset    , sourceColBegin);
+					const uint8_t*  row1    = sourceRow(row + run.rowOffset + 1, sourceColBegin);
+					const uint16_t* weight  = weights.data() + run.begin;
+					uint8_t*        destPtr = destRow + run.begin;
+					const int       num     = run.end - run.begin;
+
+					// contiguous rows, vectorised by the compiler
+					for(int i = 0; i < num; ++i)
+						destPtr[i] = static_cast<uint8_t>((row0[i]*(interScale - weight[i]) + row1[i]*weight[i] + interScale/2) >> interBits);
+				}
+			}
+		}
+	}
+
+	void columnShift(const cv::Mat& src, cv::Mat& dest, const ColumnShift& shift, uint8_t fillValue, bool linear)
+	{
+		if(src.type() == cv::DataType<uint8_t>::type)
+		{
+			columnShiftUInt8(src, dest, shift, fillValue, linear);
+			return;
+		}
+
+		const cv::Mat transMat = (cv::Mat_<double>(2,3) << 1, 0, shift.shiftX, shift.slopeY, 1, shift.offsetY);
+		cv::warpAffine(src, dest, transMat, src.size(), linear ? cv::INTER_LINEAR : cv::INTER_NEAREST, cv::BORDER_CONSTANT, cv::Scalar::all(fillValue));
+	}
+}
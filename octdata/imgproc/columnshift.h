@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace cv { class Mat; }
+
+namespace OctData
+{
+	/**
+	 * registration of a B-scan without rotation: the source column c is moved to the column c + shiftX
+	 * and shifted down by getShiftY(c) pixels (used for the images and the segmentation lines)
+	 */
+	struct ColumnShift
+	{
+		int    shiftX  = 0;
+		double offsetY = 0;
+		double slopeY  = 0;
+
+		double getShiftY(int sourceCol)                        const { return offsetY + slopeY*sourceCol; }
+	};
+
+	/**
+	 * dest(y, c + shiftX) = src(y - getShiftY(c), c), replaces cv::warpAffine with the matrix [1, 0, shiftX; slopeY, 1, offsetY]
+	 * linear: linear interpolation between the rows (1/32 pixel like cv::warpAffine), else the nearest row
+	 * pixels outside of src are fillValue, CV_8UC1 (other types with cv::warpAffine), dest is created and must not be src
+	 */
+	void columnShift(const cv::Mat& src, cv::Mat& dest, const ColumnShift& shift, uint8_t fillValue, bool linear);
+}
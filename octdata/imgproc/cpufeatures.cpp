@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cpufeatures.h"
+
+#if defined(OCTDATA_X86) && defined(_MSC_VER)
+	#include <intrin.h>
+	#include <immintrin.h>
+#endif
+
+namespace OctData
+{
+
+#if defined(OCTDATA_X86) && (defined(__GNUC__) || defined(__clang__))
+
+	CpuFeatures::CpuFeatures()
+	{
+		__builtin_cpu_init();
+		sse2   = __builtin_cpu_supports("sse2"   );
+		ssse3  = __builtin_cpu_supports("ssse3"  );
+		avx2   = __builtin_cpu_supports("avx2"   );
+		avx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+	}
+
+#elif defined(OCTDATA_X86) && defined(_MSC_VER)
+
+	CpuFeatures::CpuFeatures()
+	{
+		int info[4];
+		__cpuid(info, 0);
+		const int maxLeaf = info[0];
+
+		__cpuid(info, 1);
+		sse2  = (info[3] & (1 << 26)) != 0;
+		ssse3 = (info[2] & (1 <<  9)) != 0;
+
+		const bool osxsave = (info[2] & (1 << 27)) != 0;
+		if(!osxsave || maxLeaf < 7)
+			return;
+
+		const unsigned long long xcr0 = _xgetbv(0);
+		const bool osAvx    = (xcr0 & 0x06) == 0x06; // xmm, ymm
+		const bool osAvx512 = (xcr0 & 0xe6) == 0xe6; // xmm, ymm, opmask, zmm
+
+		__cpuidex(info, 7, 0);
+		avx2   = osAvx    && (info[1] & (1 <<  5)) != 0;
+		avx512 = osAvx512 && (info[1] & (1 << 16)) != 0 && (info[1] & (1 << 30)) != 0;
+	}
+
+#else
+
+	CpuFeatures::CpuFeatures()
+	{
+	}
+
+#endif
+
+}
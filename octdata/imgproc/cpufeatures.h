@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+	#define OCTDATA_X86
+#endif
+
+// enable instruction sets per function, the caller has to check the CPU with CpuFeatures
+#if defined(OCTDATA_X86) && (defined(__GNUC__) || defined(__clang__))
+	#define OCTDATA_TARGET_SSSE3   __attribute__((target("ssse3")))
+	#define OCTDATA_TARGET_AVX2    __attribute__((target("avx2")))
+	#define OCTDATA_TARGET_AVX512  __attribute__((target("avx512f,avx512bw")))
+#else
+	#define OCTDATA_TARGET_SSSE3
+	#define OCTDATA_TARGET_AVX2
+	#define OCTDATA_TARGET_AVX512
+#endif
+
+namespace OctData
+{
+	// instruction sets of the CPU (and supported by the OS), detected once at runtime
+	class CpuFeatures
+	{
+		bool sse2    = false;
+		bool ssse3   = false;
+		bool avx2    = false;
+		bool avx512  = false; // F + BW
+
+		CpuFeatures();
+
+		CpuFeatures(const CpuFeatures&)            = delete;
+		CpuFeatures& operator=(const CpuFeatures&) = delete;
+
+	public:
+		static const CpuFeatures& getInstance()                  { static CpuFeatures instance; return instance; }
+
+		bool hasSSE2()                                     const { return sse2  ; }
+		bool hasSSSE3()                                    const { return ssse3 ; }
+		bool hasAVX2()                                     const { return avx2  ; }
+		bool hasAVX512()                                   const { return avx512; }
+	};
+}
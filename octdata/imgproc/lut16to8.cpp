@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "lut16to8.h"
+#include "cpufeatures.h"
+
+#include <opencv2/opencv.hpp>
+
+#ifdef OCTDATA_X86
+	#include <immintrin.h>
+#endif
+
+namespace OctData
+{
+	namespace
+	{
+		void lut16To8Scalar(const uint16_t* src, uint8_t* dest, std::size_t num, const uint8_t* lut)
+		{
+			std::size_t i = 0;
+			for(; i + 4 <= num; i += 4)
+			{
+				dest[i    ] = lut[src[i    ]];
+				dest[i + 1] = lut[src[i + 1]];
+				dest[i + 2] = lut[src[i + 2]];
+				dest[i + 3] = lut[src[i + 3]];
+			}
+			for(; i < num; ++i)
+				dest[i] = lut[src[i]];
+		}
+
+#ifdef OCTDATA_X86
+		OCTDATA_TARGET_AVX2 std::size_t lut16To8AVX2(const uint16_t* src, uint8_t* dest, std::size_t num, const uint8_t* lut)
+		{
+			const int*    table    = reinterpret_cast<const int*>(lut);
+			const __m256i byteMask = _mm256_set1_epi32(0xff);
+
+			std::size_t i = 0;
+			for(; i + 16 <= num; i += 16)
+			{
+				const __m256i index   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+				const __m256i indexLo = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(index));
+				const __m256i indexHi = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(index, 1));
+
+				// 32 bit loads at the byte index (scale 1), the table entry is the lowest byte
+				const __m256i valueLo = _mm256_and_si256(_mm256_i32gather_epi32(table, indexLo, 1), byteMask);
+				const __m256i valueHi = _mm256_and_si256(_mm256_i32gather_epi32(table, indexHi, 1), byteMask);
+
+				// packs work per 128 bit lane, the permutation restores the order
+				const __m256i value16 = _mm256_permute4x64_epi64(_mm256_packus_epi32(valueLo, valueHi), 0xd8);
+				const __m128i value8  = _mm_packus_epi16(_mm256_castsi256_si128(value16), _mm256_extracti128_si256(value16, 1));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), value8);
+			}
+			return i;
+		}
+#endif
+	}
+
+
+	void lut16To8(const uint16_t* src, uint8_t* dest, std::size_t num, const uint8_t* lut)
+	{
+		std::size_t done = 0;
+#ifdef OCTDATA_X86
+		if(CpuFeatures::getInstance().hasAVX2())
+			done = lut16To8AVX2(src, dest, num, lut);
+#endif
+		lut16To8Scalar(src + done, dest + done, num - done, lut);
+	}
+
+	void lut16To8(const cv::Mat& src, cv::Mat& dest, const uint8_t* lut)
+	{
+		dest.create(src.rows, src.cols, cv::DataType<uint8_t>::type);
+
+		if(src.isContinuous() && dest.isContinuous())
+		{
+			lut16To8(src.ptr<uint16_t>(), dest.ptr<uint8_t>(), src.total(), lut);
+			return;
+		}
+
+		for(int row = 0; row < src.rows; ++row)
+			lut16To8(src.ptr<uint16_t>(row), dest.ptr<uint8_t>(row), static_cast<std::size_t>(src.cols), lut);
+	}
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cv { class Mat; }
+
+namespace OctData
+{
+	// entries of a table for lut16To8, the padding allows 32 bit loads (AVX2 gather) at every index
+	const std::size_t lut16To8TableSize = (1 << 16) + 4;
+
+	/**
+	 * dest[i] = lut[src[i]] for 16 bit images with a 8 bit result (gray transform tables)
+	 * lut needs lut16To8TableSize entries, the instruction set (AVX2) is selected at runtime
+	 */
+	void lut16To8(const uint16_t* src, uint8_t* dest, std::size_t num, const uint8_t* lut);
+
+	// CV_16UC1 to CV_8UC1, dest is created if needed
+	void lut16To8(const cv::Mat& src, cv::Mat& dest, const uint8_t* lut);
+}
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quadrootconvert.h"
+#include "cpufeatures.h"
+
+#include <cmath>
+#include <limits>
+
+#include <opencv2/opencv.hpp>
+
+#ifdef OCTDATA_X86
+	#include <immintrin.h>
+#endif
+
+namespace OctData
+{
+	namespace
+	{
+		inline float prepareInput(float value, QuadRootInput input)
+		{
+			switch(input)
+			{
+				case QuadRootInput::plain:
+					break;
+				case QuadRootInput::truncateOne:
+					if(value > 1.f) // NaN is not changed, like cv::threshold
+						value = 1.f;
+					break;
+				case QuadRootInput::absolute:
+					value = std::fabs(value);
+					break;
+			}
+			return value;
+		}
+
+		// rounding and saturation like the SIMD pack instructions: out of int range and NaN give 0
+		inline uint8_t toUInt8(float value)
+		{
+			if(!(value > -2147483648.f && value < 2147483648.f))
+				return 0;
+			const long rounded = std::lrint(value);
+			if(rounded < 0)
+				return 0;
+			if(rounded > 255)
+				return 255;
+			return static_cast<uint8_t>(rounded);
+		}
+
+		void quadRootScalar(const float* src, uint8_t* dest, std::size_t num, QuadRootInput input)
+		{
+			for(std::size_t i = 0; i < num; ++i)
+				dest[i] = toUInt8(std::sqrt(std::sqrt(prepareInput(src[i], input)))*255.f);
+		}
+
+#ifdef OCTDATA_X86
+		inline __m128 prepareInputSSE2(__m128 value, QuadRootInput input)
+		{
+			switch(input)
+			{
+				case QuadRootInput::plain:
+					break;
+				case QuadRootInput::truncateOne:
+					value = _mm_min_ps(_mm_set1_ps(1.f), value); // returns the second operand for NaN
+					break;
+				case QuadRootInput::absolute:
+					value = _mm_and_ps(value, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)));
+					break;
+			}
+			return value;
+		}
+
+		inline __m128i quadRootSSE2(const float* src, QuadRootInput input)
+		{
+			const __m128 value = prepareInputSSE2(_mm_loadu_ps(src), input);
+			return _mm_cvtps_epi32(_mm_mul_ps(_mm_sqrt_ps(_mm_sqrt_ps(value)), _mm_set1_ps(255.f)));
+		}
+
+		std::size_t quadRootSSE2(const float* src, uint8_t* dest, std::size_t num, QuadRootInput input)
+		{
+			std::size_t i = 0;
+			for(; i + 16 <= num; i += 16)
+			{
+				const __m128i v0 = quadRootSSE2(src + i     , input);
+				const __m128i v1 = quadRootSSE2(src + i +  4, input);
+				const __m128i v2 = quadRootSSE2(src + i +  8, input);
+				const __m128i v3 = quadRootSSE2(src + i + 12, input);
+
+				const __m128i v01 = _mm_packs_epi32(v0, v1);
+				const __m128i v23 = _mm_packs_epi32(v2, v3);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_packus_epi16(v01, v23));
+			}
+			return i;
+		}
+
+		OCTDATA_TARGET_AVX2 inline __m256i quadRootAVX2(const float* src, QuadRootInput input)
+		{
+			__m256 value = _mm256_loadu_ps(src);
+			switch(input)
+			{
+				case QuadRootInput::plain:
+					break;
+				case QuadRootInput::truncateOne:
+					value = _mm256_min_ps(_mm256_set1_ps(1.f), value);
+					break;
+				case QuadRootInput::absolute:
+					value = _mm256_and_ps(value, _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff)));
+					break;
+			}
+			return _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_sqrt_ps(_mm256_sqrt_ps(value)), _mm256_set1_ps(255.f)));
+		}
+
+		OCTDATA_TARGET_AVX2 std::size_t quadRootAVX2(const float* src, uint8_t* dest, std::size_t num, QuadRootInput input)
+		{
+			const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+			std::size_t i = 0;
+			for(; i + 32 <= num; i += 32)
+			{
+				const __m256i v0 = quadRootAVX2(src + i     , input);
+				const __m256i v1 = quadRootAVX2(src + i +  8, input);
+				const __m256i v2 = quadRootAVX2(src + i + 16, input);
+				const __m256i v3 = quadRootAVX2(src + i + 24, input);
+
+				// packs work per 128 bit lane, the permutation restores the order
+				const __m256i v01  = _mm256_packs_epi32(v0, v1);
+				const __m256i v23  = _mm256_packs_epi32(v2, v3);
+				const __m256i v8   = _mm256_packus_epi16(v01, v23);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i), _mm256_permutevar8x32_epi32(v8, order));
+			}
+			return i;
+		}
+
+		OCTDATA_TARGET_AVX512 std::size_t quadRootAVX512(const float* src, uint8_t* dest, std::size_t num, QuadRootInput input)
+		{
+			const __m512  one     = _mm512_set1_ps(1.f);
+			const __m512  factor  = _mm512_set1_ps(255.f);
+			const __m512i absMask = _mm512_set1_epi32(0x7fffffff);
+			const __m512i zero    = _mm512_setzero_si512();
+
+			std::size_t i = 0;
+			for(; i + 16 <= num; i += 16)
+			{
+				__m512 value = _mm512_loadu_ps(src + i);
+				switch(input)
+				{
+					case QuadRootInput::plain:
+						break;
+					case QuadRootInput::truncateOne:
+						value = _mm512_min_ps(one, value);
+						break;
+					case QuadRootInput::absolute:
+						value = _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(value), absMask));
+						break;
+				}
+				const __m512i converted = _mm512_cvtps_epi32(_mm512_mul_ps(_mm512_sqrt_ps(_mm512_sqrt_ps(value)), factor));
+				// out of range gives INT_MIN, like the signed packs in the SSE2/AVX2 version this ends as 0
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm512_cvtusepi32_epi8(_mm512_max_epi32(converted, zero)));
+			}
+			return i;
+		}
+#endif
+	}
+
+
+	void quadRootToUInt8(const float* src, uint8_t* dest, std::size_t num, QuadRootInput input)
+	{
+		std::size_t done = 0;
+#ifdef OCTDATA_X86
+		const CpuFeatures& cpu = CpuFeatures::getInstance();
+		if(cpu.hasAVX512())
+			done = quadRootAVX512(src, dest, num, input);
+		else if(cpu.hasAVX2())
+			done = quadRootAVX2(src, dest, num, input);
+		else if(cpu.hasSSE2())
+			done = quadRootSSE2(src, dest, num, input);
+#endif
+		quadRootScalar(src + done, dest + done, num - done, input);
+	}
+
+	void quadRootToUInt8(const cv::Mat& src, cv::Mat& dest, QuadRootInput input)
+	{
+		dest.create(src.rows, src.cols, cv::DataType<uint8_t>::type);
+
+		if(src.isContinuous() && dest.isContinuous())
+		{
+			quadRootToUInt8(src.ptr<float>(), dest.ptr<uint8_t>(), src.total(), input);
+			return;
+		}
+
+		for(int row = 0; row < src.rows; ++row)
+			quadRootToUInt8(src.ptr<float>(row), dest.ptr<uint8_t>(row), static_cast<std::size_t>(src.cols), input);
+	}
+}
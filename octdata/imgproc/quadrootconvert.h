@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cv { class Mat; }
+
+namespace OctData
+{
+	enum class QuadRootInput
+	{
+		plain      , // negative values and overflows in the conversion give 0 (like cv::Mat::convertTo)
+		truncateOne, // values > 1 are set to 1 (cv::threshold with THRESH_TRUNC), big values give 255
+		absolute     // absolute value of the input (like cv::pow with a non integer power)
+	};
+
+	/**
+	 * dest = saturate_cast<uint8_t>(255*src^0.25) in one pass,
+	 * replaces threshold, pow/sqrt(sqrt) and convertTo(CV_8U, 255)
+	 * src doesn't need any alignment, the instruction set (SSE2, AVX2, AVX-512) is selected at runtime
+	 */
+	void quadRootToUInt8(const float* src, uint8_t* dest, std::size_t num, QuadRootInput input);
+
+	// CV_32FC1 to CV_8UC1, dest is created if needed
+	void quadRootToUInt8(const cv::Mat& src, cv::Mat& dest, QuadRootInput input);
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "reversebytes.h"
+#include "cpufeatures.h"
+
+#ifdef OCTDATA_X86
+	#include <immintrin.h>
+#endif
+
+namespace OctData
+{
+	namespace
+	{
+		void reverseBytesScalar(const uint8_t* src, uint8_t* dest, std::size_t num, std::size_t begin)
+		{
+			for(std::size_t i = begin; i < num; ++i)
+				dest[num-1-i] = src[i];
+		}
+
+#ifdef OCTDATA_X86
+		OCTDATA_TARGET_SSSE3 std::size_t reverseBytesSSSE3(const uint8_t* src, uint8_t* dest, std::size_t num)
+		{
+			const __m128i reverse = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+
+			std::size_t i = 0;
+			for(; i + 16 <= num; i += 16)
+			{
+				const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + num - i - 16), _mm_shuffle_epi8(v, reverse));
+			}
+			return i;
+		}
+
+		OCTDATA_TARGET_AVX2 std::size_t reverseBytesAVX2(const uint8_t* src, uint8_t* dest, std::size_t num)
+		{
+			const __m256i reverse = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0
+			                                       , 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+
+			std::size_t i = 0;
+			for(; i + 32 <= num; i += 32)
+			{
+				const __m256i v        = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+				// the shuffle works per 128 bit lane, the permutation swaps the lanes
+				const __m256i reversed = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(v, reverse), 0x4e);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + num - i - 32), reversed);
+			}
+			return i;
+		}
+#endif
+	}
+
+
+	void reverseBytes(const uint8_t* src, uint8_t* dest, std::size_t num)
+	{
+		std::size_t done = 0;
+#ifdef OCTDATA_X86
+		const CpuFeatures& cpu = CpuFeatures::getInstance();
+		if(cpu.hasAVX2())
+			done = reverseBytesAVX2(src, dest, num);
+		else if(cpu.hasSSSE3())
+			done = reverseBytesSSSE3(src, dest, num);
+#endif
+		reverseBytesScalar(src, dest, num, done);
+	}
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "transposeflip.h"
+
+#include <algorithm>
+
+#include <opencv2/opencv.hpp>
+
+namespace OctData
+{
+	namespace
+	{
+		// 64 x 64 bytes source and destination tile: 8 KiB
+		const std::size_t tileSize = 64;
+
+		void transposeFlipTile(const uint8_t* src, std::size_t srcRows, std::size_t srcStride, uint8_t* dest, std::size_t destStride, std::size_t destRowBegin, std::size_t destRowEnd, std::size_t destColBegin, std::size_t destColEnd)
+		{
+			for(std::size_t destRow = destRowBegin; destRow < destRowEnd; ++destRow)
+			{
+				uint8_t*       destPtr = dest + destRow*destStride;
+				const uint8_t* srcPtr  = src  + (srcRows-1-destColBegin)*srcStride + destRow;
+				for(std::size_t destCol = destColBegin; destCol < destColEnd; ++destCol)
+				{
+					destPtr[destCol] = *srcPtr;
+					srcPtr -= srcStride;
+				}
+			}
+		}
+	}
+
+	void transposeFlipUInt8(const uint8_t* src, std::size_t srcRows, std::size_t srcCols, std::size_t srcStride, uint8_t* dest, std::size_t destStride)
+	{
+		const std::size_t destRows = srcCols;
+		const std::size_t destCols = srcRows;
+
+		for(std::size_t destRowBegin = 0; destRowBegin < destRows; destRowBegin += tileSize)
+		{
+			const std::size_t destRowEnd = std::min(destRowBegin + tileSize, destRows);
+			for(std::size_t destColBegin = 0; destColBegin < destCols; destColBegin += tileSize)
+			{
+				const std::size_t destColEnd = std::min(destColBegin + tileSize, destCols);
+				transposeFlipTile(src, srcRows, srcStride, dest, destStride, destRowBegin, destRowEnd, destColBegin, destColEnd);
+			}
+		}
+	}
+
+	void transposeFlipUInt8(const cv::Mat& src, cv::Mat& dest)
+	{
+		dest.create(src.cols, src.rows, cv::DataType<uint8_t>::type);
+		if(src.empty())
+			return;
+
+		transposeFlipUInt8(src.ptr<uint8_t>(), static_cast<std::size_t>(src.rows), static_cast<std::size_t>(src.cols), src.step[0], dest.ptr<uint8_t>(), dest.step[0]);
+	}
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cv { class Mat; }
+
+namespace OctData
+{
+	/**
+	 * dest(r, c) = src(srcRows-1-c, r), the same as cv::transpose followed by cv::flip(…, 1) without the temporary image
+	 * dest has srcCols rows and srcRows columns, strides in bytes, the copy is done in tiles that fit in the L1 cache
+	 */
+	void transposeFlipUInt8(const uint8_t* src, std::size_t srcRows, std::size_t srcCols, std::size_t srcStride, uint8_t* dest, std::size_t destStride);
+
+	// CV_8UC1, dest is created if needed (can be a view into a volume with the right size)
+	void transposeFlipUInt8(const cv::Mat& src, cv::Mat& dest);
+}
@@ -4,11 +4,14 @@
 #include <datastruct/coordslo.h>
 #include <datastruct/sloimage.h>
 #include <datastruct/bscan.h>
+#include <datastruct/octmetadata.h>
+#include <filereadoptions.h>
 
 #include <iostream>
 #include <fstream>
 #include <iomanip>
 #include<filesystem>
+#include<algorithm>
 
 #include <opencv2/opencv.hpp>
 
@@ -18,6 +21,7 @@
 #include <oct_cpp_framework/callback.h>
 
 #include<filereader/filereader.h>
+#include<imgproc/transposeflip.h>
 
 #include <boost/log/trivial.hpp>
 
@@ -33,44 +37,22 @@ namespace
 		std::size_t num = sizeX*sizeY;
 		stream.read(reinterpret_cast<char*>(image.data), num*sizeof(T));
 	}
-}
-
 
-namespace OctData
-{
-	CirrusRawRead::CirrusRawRead()
-	: OctFileReader(OctExtension{".img", ".img.gz", "Cirrus img files"})
+	// metadata in the filename: patientid_scantype_date_time_eye_sn_cube_filetype
+	struct CirrusFilenameInfo
 	{
+		std::string patientId;
+		std::string eyeSide;
+		std::size_t volSizeX = 0;
+		std::size_t volSizeY = 0;
+	};
 
-	}
-
-	bool CirrusRawRead::readFile(FileReader& filereader, OCT& oct, const FileReadOptions& /*op*/, CppFW::Callback* callback)
+	bool parseFilename(const std::string& filenameString, CirrusFilenameInfo& info)
 	{
-		const std::filesystem::path& file = filereader.getFilepath();
-
-		if(filereader.getExtension() != ".img")
-			return false;
-
-		BOOST_LOG_TRIVIAL(trace) << "Try to open OCT file as cirrus img";
-
-		if(!filereader.openFile())
-		{
-			BOOST_LOG_TRIVIAL(error) << "Can't open cirrus img file " << filereader.getFilepath().generic_string();
-			return false;
-		}
-		/*
-		if(file.extension() != ".img")
-			return false;
-
-		if(!bfs::exists(file))
-			return false;
-		*/
-
 		bool debug = false;
 
 		// split filename in elements
 		std::vector<std::string> elements;
-		std::string filenameString = filereader.getFilepath().filename().generic_string();
 		boost::split(elements, filenameString, boost::is_any_of("_"), boost::token_compress_on);
 
 		if(debug)
@@ -133,11 +115,13 @@ namespace OctData
 			return false;
 		}
 
-		std::size_t volSizeX = boost::lexical_cast<std::size_t>(scanSizeElements[0]);
-		std::size_t volSizeY = boost::lexical_cast<std::size_t>(scanSizeElements[1]);
+		info.patientId = patient_id;
+		info.eyeSide   = eye_side;
+		info.volSizeX  = boost::lexical_cast<std::size_t>(scanSizeElements[0]);
+		info.volSizeY  = boost::lexical_cast<std::size_t>(scanSizeElements[1]);
 
 		if(debug)
-			std::cout << "vol_size " << volSizeX << " : " << volSizeY << std::endl;
+			std::cout << "vol_size " << info.volSizeX << " : " << info.volSizeY << std::endl;
 
 		// TODO:
 /*
@@ -151,6 +135,76 @@ if strcmp(cube,'hidef')
 end
 */
 
+		return true;
+	}
+
+	// the slo is in a separate file: <patientid>_..._<sn>_lslo.bin
+	bfs::path getSloFilename(const bfs::path& file)
+	{
+		std::string fileString = file.generic_string();
+		std::size_t found = fileString.find_last_of("_");
+		found = fileString.find_last_of("_", found-1);
+		std::string baseFilename = fileString.substr(0, found);
+
+		return bfs::path(baseFilename + "_lslo.bin");
+	}
+
+	const std::size_t sloWidth = 512;
+
+	// buffer for the B-scans if the file is not mapped (compressed)
+	const std::size_t readChunkSize = 32*1024*1024;
+
+	void copyMetaData(const CirrusFilenameInfo& info, OctData::Patient& pat, OctData::Series& series)
+	{
+		pat.setId(info.patientId);
+		series.setScanPattern(OctData::Series::ScanPattern::Volume);
+		if(info.eyeSide == "OD")
+			series.setLaterality(OctData::Series::Laterality::OD);
+		else if(info.eyeSide == "OS")
+			series.setLaterality(OctData::Series::Laterality::OS);
+	}
+}
+
+
+namespace OctData
+{
+	CirrusRawRead::CirrusRawRead()
+	: OctFileReader(OctExtension{".img", ".img.gz", "Cirrus img files"})
+	{
+
+	}
+
+	bool CirrusRawRead::readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* callback) const
+	{
+		const std::filesystem::path& file = filereader.getFilepath();
+
+		if(filereader.getExtension() != ".img")
+			return false;
+
+		BOOST_LOG_TRIVIAL(trace) << "Try to open OCT file as cirrus img";
+
+		if(!filereader.openFile())
+		{
+			BOOST_LOG_TRIVIAL(error) << "Can't open cirrus img file " << filereader.getFilepath().generic_string();
+			return false;
+		}
+		/*
+		if(file.extension() != ".img")
+			return false;
+
+		if(!bfs::exists(file))
+			return false;
+		*/
+
+		bool debug = false;
+
+		CirrusFilenameInfo info;
+		if(!parseFilename(filereader.getFilepath().filename().generic_string(), info))
+			return false;
+
+		const std::size_t volSizeX = info.volSizeX;
+		const std::size_t volSizeY = info.volSizeY;
+
 // 		std::size_t filesize = bfs::file_size(file);
 		std::size_t filesize = filereader.file_size();
 		std::size_t volSizeZ = filesize / volSizeX /volSizeY;
@@ -171,12 +225,31 @@ end
 
 		Patient& pat    = oct.getPatient(0);
 		Series&  series = pat.getStudy(0).getSeries(0);
+		copyMetaData(info, pat, series);
 
 		std::vector<std::shared_ptr<BScan>> bscanList;
 
 		BScan::Data data;
 		data.scaleFactor = sf;
-		for(std::size_t i = 0; i<volSizeY; ++i)
+		const std::size_t numBScans = op.readBScans ? volSizeY : 0;
+
+		// the B-scans are stored in reverse order, slice numBScans-1-i is B-scan i of the file
+		if(numBScans > 0)
+			series.createVolume(static_cast<int>(numBScans), static_cast<int>(volSizeX), static_cast<int>(volSizeZ), cv::DataType<uint8_t>::type);
+
+		// the whole cube from the mapping, else in chunks of B-scans with one sequential read each
+		const std::size_t bscanSize = volSizeZ*volSizeX;
+		filereader.adviseSequential();
+		const uint8_t*    cube      = reinterpret_cast<const uint8_t*>(filereader.mapRegion(0, numBScans*bscanSize));
+		const std::size_t chunkBScans = cube ? numBScans : std::max(std::size_t(1), readChunkSize/std::max(bscanSize, std::size_t(1)));
+		std::vector<uint8_t> chunkBuffer;
+		if(!cube && numBScans > 0)
+		{
+			chunkBuffer.resize(std::min(chunkBScans, numBScans)*bscanSize);
+			filereader.seekg(0);
+		}
+
+		for(std::size_t i = 0; i<numBScans; ++i)
 		{
 			if(callback)
 			{
@@ -184,28 +257,35 @@ end
 					break;
 			}
 
-			cv::Mat bscanImage;
-// 			readCVImage<uint8_t>(stream, bscanImage, volSizeZ, volSizeX);
-			filereader.readCVImage<uint8_t>(bscanImage, volSizeZ, volSizeX);
-// 			cv::flip(bscanImage, bscanImage, -1);
-			cv::transpose(bscanImage, bscanImage);
-			cv::flip(bscanImage, bscanImage, 1);
+			const std::size_t chunkIndex = i % chunkBScans;
+			if(!cube && chunkIndex == 0)
+				filereader.readFStream<uint8_t>(chunkBuffer.data(), std::min(chunkBScans, numBScans - i)*bscanSize);
+
+			const uint8_t* bscanRaw = cube ? cube + i*bscanSize : chunkBuffer.data() + chunkIndex*bscanSize;
+
+			// transposed and flipped directly into the volume, the mapping is not needed afterwards
+			cv::Mat bscanImage = series.getVolumeSlice(static_cast<int>(numBScans-1-i));
+			transposeFlipUInt8(bscanRaw, volSizeZ, volSizeX, volSizeX, bscanImage.ptr<uint8_t>(), bscanImage.step[0]);
 
 			bscanList.push_back(std::make_shared<BScan>(bscanImage, data));
 		}
 
-		for(std::vector<std::shared_ptr<BScan>>::reverse_iterator it = bscanList.rbegin(); it != bscanList.rend(); ++it)
-			series.addBScan(*it);
+		series.addBScans(std::vector<std::shared_ptr<BScan>>(bscanList.rbegin(), bscanList.rend()));
+
+		if(bscanList.size() < numBScans)
+		{
+			// canceled, only the slices of the read B-scans
+			const cv::Range ranges[] = { cv::Range(static_cast<int>(numBScans - bscanList.size()), static_cast<int>(numBScans)), cv::Range::all(), cv::Range::all() };
+			series.setVolume(bscanList.empty() ? cv::Mat() : series.getVolume()(ranges));
+		}
 
 		//------------
 		// load slo
 		//------------
-		std::string fileString = file.generic_string();
-		std::size_t found = fileString.find_last_of("_");
-		found = fileString.find_last_of("_", found-1);
-		std::string baseFilename = fileString.substr(0, found);
+		if(!op.readSlo)
+			return true;
 
-		bfs::path slofile(baseFilename + "_lslo.bin");
+		bfs::path slofile = getSloFilename(file);
 		std::cout << slofile.generic_string() << std::endl;
 		if(!bfs::exists(slofile))
 			return true; // bscans loaded successfull
@@ -217,7 +297,6 @@ end
 		cv::Mat sloImage;
 		std::size_t filesizeSlo = bfs::file_size(slofile);
 
-		std::size_t sloWidth = 512;
 		readCVImage<uint8_t>(streamSlo, sloImage, sloWidth, filesizeSlo/sloWidth);
 		std::unique_ptr<SloImage> slo = std::make_unique<SloImage>();
 		slo->setImage(sloImage);
@@ -230,4 +309,32 @@ end
 	}
 
 
+	bool CirrusRawRead::scanMetadata(FileReader& filereader, OctMetadata& metadata, const FileReadOptions& /*op*/) const
+	{
+		if(filereader.getExtension() != ".img")
+			return false;
+
+		CirrusFilenameInfo info;
+		if(!parseFilename(filereader.getFilepath().filename().generic_string(), info) || info.volSizeX == 0 || info.volSizeY == 0)
+			return false;
+
+		Patient pat   (0);
+		Study   study (0);
+		Series  series(0);
+		copyMetaData(info, pat, series);
+
+		SeriesMetadata& entry = metadata.addSeries(pat, study, series);
+		entry.numBScans   = info.volSizeY;
+		entry.bscanWidth  = static_cast<int>(filereader.file_size() / info.volSizeX / info.volSizeY); // transposed in readFile
+		entry.bscanHeight = static_cast<int>(info.volSizeX);
+
+		const bfs::path slofile = getSloFilename(filereader.getFilepath());
+		if(bfs::exists(slofile))
+		{
+			entry.sloWidth  = static_cast<int>(bfs::file_size(slofile)/sloWidth);
+			entry.sloHeight = static_cast<int>(sloWidth);
+		}
+		return true;
+	}
+
 }
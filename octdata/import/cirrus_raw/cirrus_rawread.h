@@ -17,7 +17,8 @@ namespace OctData
 	public:
 		CirrusRawRead();
 
-		virtual bool readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* callback) override;
+		virtual bool readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* callback) const override;
+		virtual bool scanMetadata(FileReader& filereader, OctMetadata& metadata, const FileReadOptions& op) const override;
 	};
 
 }
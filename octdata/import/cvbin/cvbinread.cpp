@@ -2,6 +2,7 @@
 
 #include<locale>
 #include<filesystem>
+#include<mutex>
 
 #include <boost/log/trivial.hpp>
 #include <boost/lexical_cast.hpp>
@@ -92,6 +93,16 @@ namespace OctData
 			}
 		}
 
+		void readBScanParameter(const CppFW::CVMatTree& bscanNode, BScan& bscan)
+		{
+			CppFW::GetFromCVMatTree bscanReader(bscanNode.getDirNodeOpt("data"));
+			bscan.getSetParameter(bscanReader);
+
+			const CppFW::CVMatTree* angioNode = bscanNode.getDirNodeOpt("angioImg");
+			if(angioNode && angioNode->type() == CppFW::CVMatTree::Type::Mat)
+				bscan.setAngioImage(angioNode->getMat());
+		}
+
 		std::shared_ptr<BScan> readBScan(const CppFW::CVMatTree* bscanNode)
 		{
 			if(!bscanNode)
@@ -122,14 +133,7 @@ namespace OctData
 					fillSegmentationsLines(seriesSegNode, bscanData);
 
 					bscan = std::make_shared<BScan>(img, bscanData);
-
-					CppFW::GetFromCVMatTree bscanReader(bscanNode->getDirNodeOpt("data"));
-					bscan->getSetParameter(bscanReader);
-
-
-					const CppFW::CVMatTree* angioNode = bscanNode->getDirNodeOpt("angioImg");
-					if(angioNode && angioNode->type() == CppFW::CVMatTree::Type::Mat)
-						bscan->setAngioImage(angioNode->getMat());
+					readBScanParameter(*bscanNode, *bscan);
 				}
 			}
 
@@ -141,24 +145,144 @@ namespace OctData
 			BOOST_LOG_TRIVIAL(trace) << "read bscan list";
 
 			CppFW::CallbackStepper bscanCallbackStepper(callback, seriesList.size());
+			std::vector<std::shared_ptr<BScan>> bscans;
+			bscans.reserve(seriesList.size());
 			for(const CppFW::CVMatTree* bscanNode : seriesList)
 			{
 				if(++bscanCallbackStepper == false)
+				{
+					series.addBScans(std::move(bscans));
 					return false;
+				}
 
 				std::shared_ptr<BScan> bscan = readBScan(bscanNode);
 				if(bscan)
-					series.addBScan(std::move(bscan));
+					bscans.push_back(std::move(bscan));
+			}
+			series.addBScans(std::move(bscans));
+			return true;
+		}
+
+
+		// B-scan images of a series in an own octbin file (FileWriteOptions::octBinSeriesFiles), the file is read on the first access
+		// and kept as a whole, so the B-scans of this source get no image cache (bscanCacheSize is not used)
+		class CvBinSeriesFile
+		{
+			std::mutex                             mutex;
+			const std::string                      filename;
+			CppFW::CVMatTree                       tree;
+			const CppFW::CVMatTree::NodeList*      imageList = nullptr;
+			bool                                   loaded    = false;
+
+			bool loadLocked()
+			{
+				if(!loaded)
+				{
+					loaded = true;
+					BOOST_LOG_TRIVIAL(trace) << "read octbin series file " << filename;
+					tree = CppFW::CVMatTreeStructBin::readBin(filename, nullptr);
+
+					const CppFW::CVMatTree* bscansNode = tree.type() == CppFW::CVMatTree::Type::Dir ? tree.getDirNodeOpt("bscans") : nullptr;
+					if(bscansNode && bscansNode->type() == CppFW::CVMatTree::Type::List)
+						imageList = &bscansNode->getNodeList();
+					else
+						BOOST_LOG_TRIVIAL(error) << "false internal structure of octbin series file " << filename;
+				}
+				return imageList != nullptr;
+			}
+
+		public:
+			explicit CvBinSeriesFile(const std::filesystem::path& file) : filename(file.generic_string()) {}
+
+			bool load()
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				return loadLocked();
+			}
+
+			cv::Mat getImage(std::size_t index)
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if(!loadLocked() || index >= imageList->size())
+					return cv::Mat();
+
+				const CppFW::CVMatTree* imageNode = (*imageList)[index];
+				const CppFW::CVMatTree* imgNode   = imageNode ? imageNode->getDirNodeOpt("img") : nullptr;
+				if(imgNode && imgNode->type() == CppFW::CVMatTree::Type::Mat)
+					return imgNode->getMat();
+				return cv::Mat();
+			}
+		};
+
+		// B-scans of the index in the main file, the images are taken from the series file (with lazyBScans on the first access)
+		bool readIndexedBScanList(const CppFW::CVMatTree::NodeList& seriesList, const std::filesystem::path& seriesFile, Series& series, const FileReadOptions& op, CppFW::Callback* callback)
+		{
+			BOOST_LOG_TRIVIAL(trace) << "read indexed bscan list";
+
+			if(!op.readBScans)
+				return true;
+
+			std::shared_ptr<CvBinSeriesFile> seriesImages = std::make_shared<CvBinSeriesFile>(seriesFile);
+			if(!op.lazyBScans && !seriesImages->load())
+				return false;
+
+			CppFW::CallbackStepper bscanCallbackStepper(callback, seriesList.size());
+			std::vector<std::shared_ptr<BScan>> bscans;
+			bscans.reserve(seriesList.size());
+			for(std::size_t index = 0; index < seriesList.size(); ++index)
+			{
+				if(++bscanCallbackStepper == false)
+				{
+					series.addBScans(std::move(bscans));
+					return false;
+				}
+
+				const CppFW::CVMatTree* bscanNode = seriesList[index];
+				if(!bscanNode)
+					continue;
+
+				const int width  = CppFW::CVMatTreeExtra::getCvScalar(bscanNode, "imgWidth" , 0);
+				const int height = CppFW::CVMatTreeExtra::getCvScalar(bscanNode, "imgHeight", 0);
+				if(width <= 0 || height <= 0)
+					continue;
+
+				BScan::Data bscanData;
+				const CppFW::CVMatTree* seriesSegNode = getDirNodeOptCamelCase(*bscanNode, "segmentations");
+				fillSegmentationsLines(seriesSegNode, bscanData);
+
+				std::shared_ptr<BScan> bscan;
+				if(op.lazyBScans)
+				{
+					BScan::ImageLoader loader = [seriesImages, index](cv::Mat& image, cv::Mat& /*rawImage*/) { image = seriesImages->getImage(index); };
+					bscan = std::make_shared<BScan>(loader, width, height, bscanData);
+				}
+				else
+				{
+					cv::Mat img = seriesImages->getImage(index);
+					if(img.empty())
+						continue;
+					bscan = std::make_shared<BScan>(img, bscanData);
+				}
+
+				readBScanParameter(*bscanNode, *bscan);
+				bscans.push_back(std::move(bscan));
 			}
+			series.addBScans(std::move(bscans));
 			return true;
 		}
 
+		struct ReadContext
+		{
+			const std::filesystem::path& directory;
+			const FileReadOptions&       op;
+		};
+
 
 
 
 		// deep file format (support many scans per file, tree structure)
 		template<typename S>
-		bool readStructure(const CppFW::CVMatTree& tree, S& structure, CppFW::Callback* callback)
+		bool readStructure(const CppFW::CVMatTree& tree, S& structure, const ReadContext& context, CppFW::Callback* callback)
 		{
 			bool result = true;
 			const CppFW::CVMatTree* dataNode = tree.getDirNodeOpt("data");
@@ -182,7 +306,7 @@ namespace OctData
 					try
 					{
 						int id = boost::lexical_cast<int>(nodeIdStr);
-						readStructure(*(subNodePair.second), structure.getInsertId(id), callback);
+						readStructure(*(subNodePair.second), structure.getInsertId(id), context, callback);
 					}
 					catch(const boost::bad_lexical_cast&)
 					{
@@ -194,7 +318,7 @@ namespace OctData
 
 
 		template<>
-		bool readStructure<Series>(const CppFW::CVMatTree& tree, Series& series, CppFW::Callback* callback)
+		bool readStructure<Series>(const CppFW::CVMatTree& tree, Series& series, const ReadContext& context, CppFW::Callback* callback)
 		{
 			const CppFW::CVMatTree* dataNode = tree.getDirNodeOpt("data");
 			if(dataNode)
@@ -212,12 +336,28 @@ namespace OctData
 				return false;
 
 			const CppFW::CVMatTree::NodeList& seriesList = bscansNode->getNodeList();
+
+			// without the index node (written with FileWriteOptions::octBinSeriesFiles) the images are part of the tree
+			const CppFW::CVMatTree* bscansFileNode = tree.getDirNodeOpt("bscansFile");
+			if(bscansFileNode && bscansFileNode->type() == CppFW::CVMatTree::Type::String)
+			{
+				// only a file next to the main file, no path from the file content
+				const std::string& bscansFile = bscansFileNode->getString();
+				const bfs::path bscansFilePath(bscansFile);
+				if(bscansFile.empty() || bscansFilePath.filename() != bscansFilePath || bscansFilePath == "." || bscansFilePath == "..")
+				{
+					BOOST_LOG_TRIVIAL(error) << "octbin series file is not a plain filename: " << bscansFile;
+					return false;
+				}
+				return readIndexedBScanList(seriesList, context.directory / bscansFile, series, context.op, callback);
+			}
+
 			return readBScanList(seriesList, series, callback);
 		}
 
-		bool readTreeData(OCT& oct, const CppFW::CVMatTree& octtree, CppFW::Callback* callback)
+		bool readTreeData(OCT& oct, const CppFW::CVMatTree& octtree, const ReadContext& context, CppFW::Callback* callback)
 		{
-			return readStructure(octtree, oct, callback);
+			return readStructure(octtree, oct, context, callback);
 		}
 
 
@@ -279,7 +419,7 @@ namespace OctData
 	{
 	}
 
-	bool CvBinRead::readFile(FileReader& filereader, OCT& oct, const FileReadOptions& /*op*/, CppFW::Callback* callback)
+	bool CvBinRead::readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* callback) const
 	{
 		const std::filesystem::path& file = filereader.getFilepath();
 //
@@ -313,7 +453,10 @@ namespace OctData
 		if(seriesNode)
 			fillStatus = readFlatData(oct, octtree, seriesNode, &convertTask);
 		else
-			fillStatus = readTreeData(oct, octtree, &convertTask);
+		{
+			const std::filesystem::path directory = file.parent_path();
+			fillStatus = readTreeData(oct, octtree, ReadContext{directory, op}, &convertTask);
+		}
 
 
 
@@ -10,7 +10,7 @@ namespace OctData
 	public:
 		CvBinRead();
 
-		virtual bool readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* callback) override;
+		virtual bool readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* callback) const override;
 	};
 }
 
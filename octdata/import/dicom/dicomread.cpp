@@ -117,11 +117,12 @@ namespace OctData
 	DicomRead::DicomRead()
 	: OctFileReader({OctExtension{".dicom", ".dcm", "Dicom File"}, OctExtension("DICOMDIR", "DICOM DIR")})
 	{
+		addOptionalSignature(128, "DICM"); // behind the preamble, older files have no preamble
 	}
 
 
 #if false
-	bool DicomRead::readFile(FileReader& filereader, OCT& oct, const FileReadOptions& /*op*/, CppFW::Callback* /*callback*/)
+	bool DicomRead::readFile(FileReader& filereader, OCT& oct, const FileReadOptions& /*op*/, CppFW::Callback* /*callback*/) const
 // 	bool readFile(const std::filesystem::path& file, OCT& oct, const FileReadOptions& /*op*/, CppFW::Callback* /*callback*/)
 	{
 		const std::filesystem::path& file = filereader.getFilepath();
@@ -163,7 +164,7 @@ namespace OctData
 		return false;
 	}
 
-	bool DicomRead::readDicomDir(const std::filesystem::path& file, OCT& /*oct*/)
+	bool DicomRead::readDicomDir(const std::filesystem::path& file, OCT& /*oct*/) const
 	{
 		DcmDicomDir dicomdir(file.c_str());
 
@@ -367,14 +368,15 @@ namespace OctData
 		}
 	}
 
-	bool DicomRead::readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* callback)
+	bool DicomRead::readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* callback) const
 // 	void ReadDICOM::readFile(const std::string& filename, CScan* cscan)
 	{
 		const std::string filename = filereader.getFilepath().generic_string();
 
 		std::string ext = filereader.getFilepath().extension().generic_string();
 		std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-		if(ext != ".dicom"
+		if(!filereader.isSignatureMatch()
+		&& ext != ".dicom"
 		&& ext != ".dcm")
 			return false;
 
@@ -391,24 +393,24 @@ namespace OctData
 			return false;
 
 
-		result = data->findAndGetSint32Array(DcmTagKey(0x0073, 0x1125), registerArray, &numRegisterElements);
+		FileState state;
+		result = data->findAndGetSint32Array(DcmTagKey(0x0073, 0x1125), state.registerArray, &state.numRegisterElements);
 		if(result.bad())
 		{
-			registerArray       = nullptr;
-			numRegisterElements = 0;
+			state.registerArray       = nullptr;
+			state.numRegisterElements = 0;
 		}
 
 		// data->print(std::cout);
-		
-		bscans = 0;
 
 		std::string pixelSpacingStr = getStdString(*data, DCM_PixelSpacing);
 		if(!pixelSpacingStr.empty())
 		{
 			std::istringstream pixelSpaceingStream(pixelSpacingStr);
 			char c;
-			pixelSpaceingStream >> pixelSpaceingX >> c >> pixelSpaceingZ;
+			pixelSpaceingStream >> state.pixelSpaceingX >> c >> state.pixelSpaceingZ;
 		}
+		data->findAndGetFloat64(DCM_SpacingBetweenSlices, state.spacingBetweenSlices);
 		/*
 		DcmElement* pixelSpaceingElement = nullptr;
 		result = data->findAndGetElement(DCM_PixelSpacing, pixelSpaceingElement);
@@ -426,14 +428,14 @@ namespace OctData
 		DcmElement* element = nullptr;
 		result = data->findAndGetElement(DCM_PixelData, element);
 		if(!result.bad() && element != nullptr)
-			readPixelData(element, series, op, callback);
+			readPixelData(state, element, series, op, callback);
 		else
 		{
 			DcmSequenceOfItems* items = nullptr;
 			result = data->findAndGetSequence(DcmTagKey(0x0407, 0x10a1), items);
 // 			result = data->findAndGetElement(DcmTagKey(0x0407, 0x10a1), element);
 			if(!result.bad() && items != nullptr)
-				readDict(items, series, op, callback);
+				readDict(state, items, series, op, callback);
 			else
 			{
 				BOOST_LOG_TRIVIAL(error) << "cant find PixelData";
@@ -467,14 +469,12 @@ namespace OctData
 
 		series.setSeriesUID(getStdString(*data, DCM_SeriesInstanceUID));
 
-		data->findAndGetFloat64(DCM_SpacingBetweenSlices, spacingBetweenSlices);
-
 
 		return true;
 	}
 	#endif
 
-	void DicomRead::readDict(DcmSequenceOfItems* sequence, Series& series, const FileReadOptions& op, CppFW::Callback* /*callback*/)
+	void DicomRead::readDict(FileState& state, DcmSequenceOfItems* sequence, Series& series, const FileReadOptions& op, CppFW::Callback* /*callback*/) const
 	{
 		DcmStack stack;
 		DcmObject* object = nullptr;
@@ -497,17 +497,17 @@ namespace OctData
 				if(i++!=4)
 					continue;
 				for(int i = 0; i < 300; ++i)
-					decodeImage(series, op, reinterpret_cast<char*>(data), length);
+					decodeImage(state, series, op, reinterpret_cast<char*>(data), length);
 				break;
 #else
-				decodeImage(series, op, reinterpret_cast<char*>(data), length);
+				decodeImage(state, series, op, reinterpret_cast<char*>(data), length);
 #endif
 			}
 		}
 	}
 	
 	
-	void DicomRead::readPixelItem(DcmPixelSequence* dseq, Series& series, const FileReadOptions& op, unsigned long i)
+	void DicomRead::readPixelItem(FileState& state, DcmPixelSequence* dseq, Series& series, const FileReadOptions& op, unsigned long i) const
 	{
 		OFCondition result;
 		Uint8* pixData = nullptr;
@@ -533,10 +533,10 @@ namespace OctData
 
 		// Get the length of this pixel item (i.e. fragment, i.e. most of the time, the lenght of the frame)
 		Uint32 length = pixitem->getLength();
-		decodeImage(series, op, reinterpret_cast<char*>(pixData), length);
+		decodeImage(state, series, op, reinterpret_cast<char*>(pixData), length);
 	}
 
-	void DicomRead::readPixelData(DcmElement* element, Series& series, const FileReadOptions& op, CppFW::Callback* callback)
+	void DicomRead::readPixelData(FileState& state, DcmElement* element, Series& series, const FileReadOptions& op, CppFW::Callback* callback) const
 	{
 		DcmPixelData* dpix = OFstatic_cast(DcmPixelData*, element);
 		/* Since we have compressed data, we must utilize DcmPixelSequence
@@ -562,12 +562,12 @@ namespace OctData
 // 			#pragma omp parallel for ordered schedule(dynamic)
 			if(op.readBScanNum >=0)
 			{
-				readPixelItem(dseq, series, op, op.readBScanNum);
+				readPixelItem(state, dseq, series, op, op.readBScanNum);
 				return;
 			}
 #if false	
 			for(int i = 0; i < 1000; ++i)
-				readPixelItem(dseq, series, op, 4);
+				readPixelItem(state, dseq, series, op, 4);
 			
 			callback->callback(0.5);
 #else
@@ -581,7 +581,7 @@ namespace OctData
 					if(!callback->callback(static_cast<double>(i)/static_cast<double>(maxEle)))
 						break;
 				}
-				readPixelItem(dseq, series, op, k);
+				readPixelItem(state, dseq, series, op, k);
 
 // 				std::cout << " ---- " << i << std::endl;
 
@@ -736,13 +736,13 @@ namespace OctData
 	}
 	
 	
-	void DicomRead::decodeImage(Series& series, const FileReadOptions& op, char* pixData, std::size_t length)
+	void DicomRead::decodeImage(FileState& state, Series& series, const FileReadOptions& op, char* pixData, std::size_t length) const
 	{
 		std::unique_ptr<char[]> copyPixData{new char[length]};
 		memcpy(copyPixData.get(), pixData, length);
 
-		std::size_t actBScan = bscans;
-		++bscans;
+		std::size_t actBScan = state.bscans;
+		++state.bscans;
 
 		std::ofstream stream("img_" + std::to_string(actBScan) + ".bim", std::ios::binary);
 		stream.write(pixData, length);
@@ -783,10 +783,10 @@ namespace OctData
 		bool flip = false; // for Cirrus
 		obj.getImage(gray_image, flip);
 
-		if(op.registerBScanns && numRegisterElements > actBScan)
+		if(op.registerBScanns && state.numRegisterElements > actBScan)
 		{
 			// std::cout << "shift X: " << reg->values[9] << std::endl;
-			double shiftY = -registerArray[actBScan];
+			double shiftY = -state.registerArray[actBScan];
 			double shiftX = 0;
 			// std::cout << "shift X: " << shiftX << "\tdegree: " << degree << "\t" << (degree*bscanImageConv.cols/2) << std::endl;
 			cv::Mat trans_mat = (cv::Mat_<double>(2,3) << 1, 0, shiftX, 0, 1, shiftY);
@@ -805,7 +805,7 @@ namespace OctData
 			if(!gray_image.empty())
 			{
 				BScan::Data bscanData;
-				bscanData.scaleFactor = ScaleFactor(pixelSpaceingX, spacingBetweenSlices, pixelSpaceingZ);
+				bscanData.scaleFactor = ScaleFactor(state.pixelSpaceingX, state.spacingBetweenSlices, state.pixelSpaceingZ);
 				series.addBScan(std::make_shared<BScan>(gray_image, bscanData));
 			}
 			else
@@ -826,7 +826,7 @@ namespace OctData
 	: OctFileReader()
 	{ }
 
-	bool DicomRead::readFile(OctData::FileReader& /*filereader*/, OctData::OCT& /*oct*/, const OctData::FileReadOptions& /*op*/, CppFW::Callback* /*callback*/)
+	bool DicomRead::readFile(OctData::FileReader& /*filereader*/, OctData::OCT& /*oct*/, const OctData::FileReadOptions& /*op*/, CppFW::Callback* /*callback*/) const
 	{
 		return false;
 	}
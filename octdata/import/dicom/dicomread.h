@@ -17,28 +17,32 @@ namespace OctData
 
 	class DicomRead : public OctFileReader
 	{
-		bool readDicomDir(const std::filesystem::path& file, OCT& oct);
+		// state of one read file, the reader object is shared by all threads
+		struct FileState
+		{
+			double spacingBetweenSlices = 0;
+			double pixelSpaceingX = 0;
+			double pixelSpaceingZ = 0;
 
-		void decodeImage(Series& series, const FileReadOptions& op, char* pixData, std::size_t length);
+			const int32_t* registerArray = nullptr;
+			unsigned long numRegisterElements = 0;
 
-		void readPixelData(DcmElement* element, Series& series, const FileReadOptions& op, CppFW::Callback* callback);
-		void readPixelItem(DcmPixelSequence* dseq, Series& series, const FileReadOptions& op, unsigned long i);
-		void readDict(DcmSequenceOfItems* element, Series& series, const FileReadOptions& op, CppFW::Callback* callback);
+			std::size_t bscans = 0;
+		};
 
-		double spacingBetweenSlices = 0;
-		double pixelSpaceingX = 0;
-		double pixelSpaceingZ = 0;
+		bool readDicomDir(const std::filesystem::path& file, OCT& oct) const;
 
-		const int32_t* registerArray = nullptr;
-		unsigned long numRegisterElements = 0;
+		void decodeImage(FileState& state, Series& series, const FileReadOptions& op, char* pixData, std::size_t length) const;
 
-		std::size_t bscans = 0;
+		void readPixelData(FileState& state, DcmElement* element, Series& series, const FileReadOptions& op, CppFW::Callback* callback) const;
+		void readPixelItem(FileState& state, DcmPixelSequence* dseq, Series& series, const FileReadOptions& op, unsigned long i) const;
+		void readDict(FileState& state, DcmSequenceOfItems* element, Series& series, const FileReadOptions& op, CppFW::Callback* callback) const;
 
 
 	public:
 	    DicomRead();
 
-	    bool readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* callback) override;
+	    bool readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* callback) const override;
 	};
 
 }
@@ -1,6 +1,7 @@
 #include "giplread.h"
 
 #include<filesystem>
+#include<algorithm>
 
 #include<boost/endian/arithmetic.hpp>
 #include <boost/log/trivial.hpp>
@@ -17,6 +18,7 @@ namespace bfs = std::filesystem;
 #include <datastruct/patient.h>
 #include <datastruct/series.h>
 #include <datastruct/bscan.h>
+#include <datastruct/octmetadata.h>
 
 #include <filereadoptions.h>
 
@@ -123,72 +125,136 @@ namespace OctData
 
 	struct ReadUInt8
 	{
-		static void readImg(FileReader& filereader, cv::Mat& image, std::size_t sizeX, std::size_t sizeY) { filereader.readCVImage<uint8_t>(image, sizeY, sizeX); }
-		static void convertImage(cv::Mat& /*image*/) {}
+		typedef uint8_t PixelType;
+
+		// the volume is a header on the mapped file if possible
+		static bool readVolume(FileReader& filereader, Series& series, std::size_t offset, int numBScans, int sizeY, int sizeX, CppFW::Callback* /*callback*/)
+		{
+			const int sizes[] = { numBScans, sizeY, sizeX };
+			const std::size_t volumeSize = static_cast<std::size_t>(numBScans)*static_cast<std::size_t>(sizeY)*static_cast<std::size_t>(sizeX);
+
+			const char* region = filereader.mapRegion(offset, volumeSize);
+			if(region)
+			{
+				series.setVolume(cv::Mat(3, sizes, cv::DataType<uint8_t>::type, const_cast<char*>(region)));
+				return true;
+			}
+
+			cv::Mat& volume = series.createVolume(numBScans, sizeY, sizeX, cv::DataType<uint8_t>::type);
+			filereader.seekg(static_cast<std::streamoff>(offset));
+			const std::streamsize bytesRead = filereader.read(reinterpret_cast<char*>(volume.data), static_cast<std::streamsize>(volumeSize));
+
+			// truncated stream: the incomplete B-scan is filled with 0, the missing B-scans are dropped
+			const std::size_t numRead = static_cast<std::size_t>(std::max<std::streamsize>(bytesRead, 0));
+			if(numRead < volumeSize)
+			{
+				const std::size_t bscanSize   = static_cast<std::size_t>(sizeY)*static_cast<std::size_t>(sizeX);
+				const int         bscansRead  = static_cast<int>((numRead + bscanSize - 1)/bscanSize);
+				BOOST_LOG_TRIVIAL(warning) << "gipl volume truncated, " << bscansRead << " of " << numBScans << " B-scans read";
+
+				std::fill(volume.data + numRead, volume.data + static_cast<std::size_t>(bscansRead)*bscanSize, static_cast<uint8_t>(0));
+				const cv::Range ranges[] = { cv::Range(0, bscansRead), cv::Range::all(), cv::Range::all() };
+				series.setVolume(bscansRead > 0 ? volume(ranges) : cv::Mat());
+			}
+			return false;
+		}
 	};
 	struct ReadUInt16
 	{
-		double maxVal = 1;
+		typedef uint16_t PixelType;
 
-		void readImg(FileReader& filereader, cv::Mat& image, std::size_t sizeX, std::size_t sizeY)
+		static bool readVolume(FileReader& filereader, Series& series, std::size_t offset, int numBScans, int sizeY, int sizeX, CppFW::Callback* callback)
 		{
-			filereader.readCVImage<uint16_t>(image, sizeY, sizeX);
-			auto imgIt    = image.begin<uint16_t>();
-			auto imgItEnd = image.end  <uint16_t>();
-
-			for(;imgIt != imgItEnd; ++imgIt)
-				boost::endian::big_to_native_inplace(*imgIt);
-
-			double min, max;
-			cv::minMaxLoc(image, &min, &max);
-			if(max > maxVal)
-				maxVal = max;
-// 			tmpImg.convertTo(image, cv::DataType<uint8_t>::type, 1./4.);
-		}
+			std::vector<cv::Mat> bscanTemp;
+			bscanTemp.reserve(static_cast<std::size_t>(numBScans));
+			double maxVal = 1;
 
-		void convertImage(cv::Mat& image)
-		{
-			image.convertTo(image, cv::DataType<uint8_t>::type, 256./maxVal);
+			// no mapping, the endian conversion is done in place
+			filereader.seekg(static_cast<std::streamoff>(offset));
+			for(int numBscan = 0; numBscan<numBScans; ++numBscan)
+			{
+				if(callback)
+					callback->callback(static_cast<double>(numBscan)/static_cast<double>(numBScans));
+
+				cv::Mat image;
+				filereader.readCVImage<uint16_t>(image, static_cast<std::size_t>(sizeY), static_cast<std::size_t>(sizeX));
+				if(!filereader.good())
+				{
+					BOOST_LOG_TRIVIAL(warning) << "gipl volume truncated, " << numBscan << " of " << numBScans << " B-scans read";
+					break;
+				}
+				auto imgIt    = image.begin<uint16_t>();
+				auto imgItEnd = image.end  <uint16_t>();
+
+				for(;imgIt != imgItEnd; ++imgIt)
+					boost::endian::big_to_native_inplace(*imgIt);
+
+				double min, max;
+				cv::minMaxLoc(image, &min, &max);
+				if(max > maxVal)
+					maxVal = max;
+// 				tmpImg.convertTo(image, cv::DataType<uint8_t>::type, 1./4.);
+				bscanTemp.push_back(image);
+			}
+
+			if(bscanTemp.empty())
+				return false;
+
+			series.createVolume(static_cast<int>(bscanTemp.size()), sizeY, sizeX, cv::DataType<uint8_t>::type);
+			for(int numBscan = 0; numBscan<static_cast<int>(bscanTemp.size()); ++numBscan)
+			{
+				cv::Mat slice = series.getVolumeSlice(numBscan);
+				bscanTemp[static_cast<std::size_t>(numBscan)].convertTo(slice, cv::DataType<uint8_t>::type, 256./maxVal);
+			}
+			return false;
 		}
 	};
 
+	/// returns true if the images are on the file mapping
 	template<typename T>
-	void readBScans(FileReader& filereader, Series& series, const OctData::FileReadOptions& op, const GIPLRead::GiplHeader& giplHeader, CppFW::Callback* callback, T reader)
+	bool readBScans(FileReader& filereader, Series& series, const OctData::FileReadOptions& op, const GIPLRead::GiplHeader& giplHeader, CppFW::Callback* callback, T reader)
 	{
-		const std::size_t sizeX     = giplHeader.getSizeX();
-		const std::size_t sizeY     = giplHeader.getSizeY();
-		const std::size_t numBScans = giplHeader.getSizeZ();
-
-		std::vector<cv::Mat> bscanTemp;
-		bscanTemp.reserve(numBScans);
-
-		for(std::size_t numBscan = 0; numBscan<numBScans; ++numBscan)
+		const int sizeX     = giplHeader.getSizeX();
+		const int sizeY     = giplHeader.getSizeY();
+		      int numBScans = giplHeader.getSizeZ();
+
+		// the header sizes are not trusted, only the B-scans which the file can hold are allocated
+		const std::size_t bscanBytes = static_cast<std::size_t>(sizeX)*static_cast<std::size_t>(sizeY)*sizeof(typename T::PixelType);
+		const std::size_t fileSize   = filereader.file_size();
+		const std::size_t numInFile  = (bscanBytes == 0 || fileSize <= GIPL_HEADERSIZE) ? 0 : (fileSize - GIPL_HEADERSIZE)/bscanBytes;
+		if(numBScans > 0 && static_cast<std::size_t>(numBScans) > numInFile)
 		{
-			if(callback)
-				callback->callback(static_cast<double>(numBscan)/static_cast<double>(numBScans));
+			BOOST_LOG_TRIVIAL(warning) << "gipl file holds " << numInFile << " of " << numBScans << " B-scans";
+			numBScans = static_cast<int>(numInFile);
+		}
+		if(numBScans <= 0)
+			return false;
 
-			cv::Mat bscanImage;
-			reader.readImg(filereader, bscanImage, sizeX, sizeY);
-// 			filereader.readCVImage<uint8_t>(bscanImage, sizeY, sizeX);
+		// all B-scans are views into the volume
+		const bool mapped = reader.readVolume(filereader, series, GIPL_HEADERSIZE, numBScans, sizeY, sizeX, callback);
 
-			bscanTemp.push_back(bscanImage);
-		}
+		// less B-scans if the file is truncated
+		const int numRead = series.hasVolume() ? series.getVolume().size[0] : 0;
 
-		for(cv::Mat& bscanImage : bscanTemp)
+		std::vector<std::shared_ptr<BScan>> bscans;
+		bscans.reserve(static_cast<std::size_t>(numRead));
+		for(int numBscan = 0; numBscan<numRead; ++numBscan)
 		{
-			reader.convertImage(bscanImage);
+			cv::Mat bscanImage = series.getVolumeSlice(numBscan);
 
 			BScan::Data bscanData;
 			std::shared_ptr<BScan> bscan = std::make_shared<BScan>(bscanImage, bscanData);
 			if(op.holdRawData)
 				bscan->setRawImage(bscanImage);
-			series.addBScan(std::move(bscan));
+			bscans.push_back(std::move(bscan));
 		}
+		series.addBScans(std::move(bscans));
+		return mapped;
 	}
 
-	bool GIPLRead::readFile(FileReader& filereader, OctData::OCT& oct, const OctData::FileReadOptions& op, CppFW::Callback* callback)
+	bool GIPLRead::readFile(FileReader& filereader, OctData::OCT& oct, const OctData::FileReadOptions& op, CppFW::Callback* callback) const
 	{
-		if(filereader.getExtension() != ".gipl")
+		if(!filereader.isSignatureMatch() && filereader.getExtension() != ".gipl")
 			return false;
 
 		const std::string filename = filereader.getFilepath().generic_string();
@@ -221,19 +287,23 @@ namespace OctData
 			return false;
 		}
 
-		filereader.seekg(GIPL_HEADERSIZE);
-
-
 		Patient& pat    = oct.getPatient(1);
 		Study&   study  = pat.getStudy(1);
 		Series&  series = study.getSeries(1); // TODO
 
-		switch(giplHeader.getType())
+		bool mapped = false;
+		if(op.readBScans)
 		{
-			case GIPLFilterType<uint8_t >::typeId: readBScans(filereader, series, op, giplHeader, callback, ReadUInt8 ()); break;
-			case GIPLFilterType<uint16_t>::typeId: readBScans(filereader, series, op, giplHeader, callback, ReadUInt16()); break;
+			switch(giplHeader.getType())
+			{
+				case GIPLFilterType<uint8_t >::typeId: mapped = readBScans(filereader, series, op, giplHeader, callback, ReadUInt8 ()); break;
+				case GIPLFilterType<uint16_t>::typeId: mapped = readBScans(filereader, series, op, giplHeader, callback, ReadUInt16()); break;
+			}
 		}
 
+		if(mapped)
+			oct.holdFileMapping(filereader.getMappingOwner());
+
 		return true;
 	}
 
@@ -241,7 +311,32 @@ namespace OctData
 	GIPLRead::GIPLRead()
 	: OctFileReader(OctExtension{".gipl", ".gipl.gz", "Guys Image Processing Lab Format"})
 	{
+		addSignature(252, std::string("\xEF\xFF\xE9\xB0", 4)); // big endian giplMagicNumber behind the header fields
 	}
 
 
+	bool GIPLRead::scanMetadata(FileReader& filereader, OctMetadata& metadata, const FileReadOptions& /*op*/) const
+	{
+		if(!filereader.isSignatureMatch() && filereader.getExtension() != ".gipl")
+			return false;
+
+		if(!filereader.openFile())
+			return false;
+
+		GiplHeader giplHeader;
+		giplHeader.readInfo(filereader);
+		if(!giplHeader.numberCheck())
+			return false;
+
+		Patient pat   (1);
+		Study   study (1);
+		Series  series(1);
+
+		SeriesMetadata& entry = metadata.addSeries(pat, study, series);
+		entry.numBScans   = giplHeader.getSizeZ();
+		entry.bscanWidth  = giplHeader.getSizeX();
+		entry.bscanHeight = giplHeader.getSizeY();
+		return true;
+	}
+
 }
@@ -3,11 +3,13 @@
 #define _USE_MATH_DEFINES
 #include<cmath>
 #include<cctype>
+#include<algorithm>
 
 #include <datastruct/oct.h>
 #include <datastruct/coordslo.h>
 #include <datastruct/sloimage.h>
 #include <datastruct/bscan.h>
+#include <datastruct/octmetadata.h>
 #include <filereadoptions.h>
 
 #include <iostream>
@@ -38,6 +40,12 @@
 #include <oct_cpp_framework/callback.h>
 
 #include"../platform_helper.h"
+#include"../parallel_helper.h"
+
+#include<imgproc/quadrootconvert.h>
+#include<imgproc/lut16to8.h>
+#include<imgproc/bordercols.h>
+#include<imgproc/columnshift.h>
 
 #include<filereader/filereader.h>
 
@@ -91,6 +99,14 @@ namespace OctData
 				pat.setAncestry(convertUTF16StringToUTF8(ancestry->getString(0)));
 		}
 		
+		Date getStudyDate(const E2E::Study& e2eStudy)
+		{
+			const E2E::StudyData* e2eStudyData = e2eStudy.getStudyData();
+			if(e2eStudyData)
+				return Date::fromWindowsTimeFormat(e2eStudyData->getWindowsStudyDate());
+			return Date();
+		}
+
 		void copyStudyData(Study& study, const E2E::Study& e2eStudy)
 		{
 			if(e2eStudy.getStudyUID())
@@ -99,7 +115,7 @@ namespace OctData
 			const E2E::StudyData* e2eStudyData = e2eStudy.getStudyData();
 			if(e2eStudyData)
 			{
-				study.setStudyDate(Date::fromWindowsTimeFormat(e2eStudyData->getWindowsStudyDate()));
+				study.setStudyDate(getStudyDate(e2eStudy));
 				study.setStudyOperator(loc::conv::to_utf<char>(e2eStudyData->getOperator(), "ISO-8859-15"));
 			}
 
@@ -150,10 +166,27 @@ namespace OctData
 			// e2eSeries.
 		}
 
+		// checked before the conversion, the metadata of the series is cheap compared to the B-scans
+		bool isSeriesSelected(const SeriesSelection& selection, int seriesId, const E2E::Series& e2eSeries, const Date& studyDate)
+		{
+			if(selection.selectsAllSeries())
+				return true;
+
+			if(!selection.acceptSeriesId(seriesId) || !selection.acceptDate(studyDate))
+				return false;
+
+			Series series(seriesId);
+			copySeriesData(series, e2eSeries);
+
+			const Series::ScanPatternEnumWrapper scanPatternName(series.getScanPattern());
+			return selection.acceptSeriesUID(series.getSeriesUID())
+			    && selection.acceptScanPattern(scanPatternName, series.getScanPatternText());
+		}
+
 		void copySlo(Series& series, const E2E::Series& e2eSeries, const FileReadOptions& op)
 		{
 			const E2E::Image* e2eSlo = e2eSeries.getSloImage();
-			if(!e2eSlo)
+			if(!e2eSlo || !op.readSlo)
 				return;
 
 			std::unique_ptr<SloImage> slo = std::make_unique<SloImage>();
@@ -207,6 +240,16 @@ namespace OctData
 			series.takeSloImage(std::move(slo));
 		}
 
+		// registration of the B-scan images and of the segmentation lines
+		ColumnShift getColumnShift(const E2E::ImageRegistration& reg, std::size_t imagecols)
+		{
+			ColumnShift shift;
+			shift.shiftX  = static_cast<int>(std::round(-reg.values[3]));
+			shift.slopeY  = -reg.values[7];
+			shift.offsetY = -reg.values[9] - shift.slopeY*static_cast<double>(imagecols)/2.;
+			return shift;
+		}
+
 		void addSegData(BScan::Data& bscanData, Segmentationlines::SegmentlineType segType, const E2E::BScan::SegmentationMap& e2eSegMap, int index, int type, const E2E::ImageRegistration* reg, std::size_t imagecols)
 		{
 			const E2E::BScan::SegmentationMap::const_iterator segPair = e2eSegMap.find(E2E::BScan::SegPair(index, type));
@@ -219,27 +262,13 @@ namespace OctData
 					Segmentationlines::Segmentline segVec(numSegData);
 					if(reg)
 					{
-						double shiftY    = -reg->values[3];
-						double degree    = -reg->values[7];
-						double shiftX    = -reg->values[9] - degree*static_cast<double>(imagecols)/2.;
-						int    shiftXVec = static_cast<int>(std::round(shiftY));
-						double pos       = shiftXVec;
-
-						Segmentationlines::Segmentline::iterator segVecBegin = segVec.begin();
+						const ColumnShift shift   = getColumnShift(*reg, imagecols);
+						const int         numData = static_cast<int>(numSegData);
+						const int         colEnd  = std::min(numData, numData - shift.shiftX);
 						E2E::SegmentationData::pointer segDataBegin = segData->begin();
 
-						std::size_t absShiftX = static_cast<std::size_t>(abs(shiftXVec));
-						if(numSegData < absShiftX)
-							return;
-
-						std::size_t numAssign = numSegData-absShiftX;
-
-						if(shiftXVec < 0)
-							segDataBegin -= shiftXVec;
-						if(shiftXVec > 0)
-							segVecBegin += shiftXVec;
-
-						std::transform(segDataBegin, segDataBegin+numAssign, segVecBegin, [&pos, shiftX, degree](double value) { return value + shiftX + (++pos)*degree; });
+						for(int col = std::max(0, -shift.shiftX); col < colEnd; ++col)
+							segVec[static_cast<std::size_t>(col + shift.shiftX)] = segDataBegin[col] + shift.getShiftY(col);
 					}
 					else
 						segVec.assign(segData->begin(), segData->end());
@@ -253,123 +282,38 @@ namespace OctData
 			}
 		}
 
-		template<typename T>
-		void fillEmptyBroderCols(cv::Mat& image, T broderValue, T fillValue)
+		// uint16 to uint8 with the table of TransformType in one pass (the B-scans are converted in parallel)
+		// empty columns at the border are white after the transform, without fillWhite they are set to black in the same pass
+		template<typename TransformType>
+		void useLUTBScan(const cv::Mat& source, cv::Mat& dest, bool fillWhite)
 		{
-			const int cols = image.cols;
-			const int rows = image.rows;
-
-			// find left Broder
-			int leftEnd = cols;
-			for(int row = 0; row<rows; ++row)
-			{
-				T* it = image.ptr<T>(row);
-				for(int col = 0; col < leftEnd; ++col)
-				{
-					if(*it != broderValue)
-					{
-						leftEnd = col;
-						break;
-					}
-					++it;
-				}
-				if(leftEnd == 0)
-					break;
-			}
-
-			// fill left Broder
-			if(leftEnd > 0)
-			{
-				for(int row = 0; row<rows; ++row)
-				{
-					T* it = image.ptr<T>(row);
-					for(int col = 0; col < leftEnd; ++col)
-					{
-						*it = fillValue;
-						++it;
-					}
-				}
-			}
+			if(fillWhite)
+				lut16To8(source, dest, TransformType::getLUT());
 			else
-				if(leftEnd == cols) // empty Image
-					return;
-
-			// find right Broder
-			int rightEnd = leftEnd;
-			for(int row = 0; row<rows; ++row)
-			{
-				T* it = image.ptr<T>(row, cols-1);
-				for(int col = cols-1; col >= rightEnd; --col)
-				{
-					if(*it != broderValue)
-					{
-						rightEnd = col;
-						break;
-					}
-					--it;
-				}
-				if(rightEnd == cols-1)
-					break;
-			}
-
-			// fill right Broder
-			if(rightEnd < cols)
-			{
-				for(int row = 0; row<rows; ++row)
-				{
-					T* it = image.ptr<T>(row, rightEnd);
-					for(int col = rightEnd; col < cols; ++col)
-					{
-						*it = fillValue;
-						++it;
-					}
-				}
-			}
-		}
-		
-		template<typename SourceType, typename DestType, typename TransformType>
-		void useLUTBScan(const cv::Mat& source, cv::Mat& dest)
-		{
-			dest.create(source.rows, source.cols, cv::DataType<DestType>::type);
-
-			TransformType& lut = TransformType::getInstance();
-			
-			const SourceType* sPtr = source.ptr<SourceType>();
-			DestType* dPtr = dest.ptr<DestType>();
-			
-			const std::size_t size = source.cols * source.rows;
-			for(size_t i = 0; i < size; ++i)
-			{
-				*dPtr = lut.getValue(*sPtr);
-				++dPtr;
-				++sPtr;
-			}
+				lut16To8FillBorderCols(source, dest, TransformType::getLUT(), 255, 0);
 		}
 
-		void transformImage(const E2E::ImageRegistration* reg, cv::Mat& image, bool fillWhite, int interpolMethod = cv::INTER_LINEAR)
+		void transformImage(const E2E::ImageRegistration* reg, cv::Mat& image, bool fillWhite, bool linear = true)
 		{
 			if(!reg)
 				return;
 
-			// std::cout << "shift X: " << reg->values[9] << std::endl;
-			double shiftY = -reg->values[3];
-			double degree = -reg->values[7];
-			double shiftX = -reg->values[9];
-			// std::cout << "shift X: " << shiftX << "\tdegree: " << degree << "\t" << (degree*bscanImageConv.cols/2) << std::endl;
-			cv::Mat trans_mat = (cv::Mat_<double>(2,3) << 1, 0, shiftY, degree, 1, shiftX - degree*image.cols/2.);
-
 			uint8_t fillValue = 0;
 			if(fillWhite)
 				fillValue = 255;
-			cv::warpAffine(image, image, trans_mat, image.size(), interpolMethod, cv::BORDER_CONSTANT, cv::Scalar(fillValue));
+
+			cv::Mat result;
+			columnShift(image, result, getColumnShift(*reg, static_cast<std::size_t>(image.cols)), fillValue, linear);
+			image = result;
 		}
 
-		void copyBScan(Series& series, const E2E::BScan& e2eBScan, const FileReadOptions& op)
+		// thread safe, the series is only read
+		std::shared_ptr<BScan> convertBScan(const Series& series, const E2E::BScan& e2eBScan, const FileReadOptions& op)
 		{
 			const E2E::Image* e2eAngioImg = e2eBScan.getAngioImage();
 			const E2E::Image* e2eBScanImg = e2eBScan.getImage();
 			if(!e2eBScanImg)
-				return;
+				return nullptr;
 
 			const cv::Mat& e2eImage = e2eBScanImg->getImage();
 
@@ -434,41 +378,35 @@ namespace OctData
 			cv::Mat bscanImageConv;
 			if(e2eImage.type() == cv::DataType<float>::type)
 			{
-				cv::Mat bscanImagePow;
-				cv::pow(e2eImage, 0.25, bscanImagePow);
-				bscanImagePow.convertTo(bscanImageConv, CV_8U, 255, 0);
+				quadRootToUInt8(e2eImage, bscanImageConv, QuadRootInput::absolute); // like cv::pow(e2eImage, 0.25) and convertTo(CV_8U, 255)
+				if(!op.fillEmptyPixelWhite)
+					fillEmptyBorderCols(bscanImageConv, 255, 0);
 			}
 			else
 			{
-				cv::Mat dest;
 				// convert image
 				switch(op.e2eGray)
 				{
 				case FileReadOptions::E2eGrayTransform::nativ:
-					e2eImage.convertTo(dest, CV_32FC1, 1/static_cast<double>(1 << 16), 0);
-					cv::pow(dest, 8, dest);
-					dest.convertTo(bscanImageConv, CV_8U, 255, 0);
+					useLUTBScan<HeGrayTransformNativ>(e2eImage, bscanImageConv, op.fillEmptyPixelWhite);
 					break;
 				case FileReadOptions::E2eGrayTransform::xml:
-					useLUTBScan<uint16_t, uint8_t, HeGrayTransformXml>(e2eImage, bscanImageConv);
+					useLUTBScan<HeGrayTransformXml>(e2eImage, bscanImageConv, op.fillEmptyPixelWhite);
 					break;
 				case FileReadOptions::E2eGrayTransform::vol:
-					useLUTBScan<uint16_t, uint8_t, HeGrayTransformVol>(e2eImage, bscanImageConv);
+					useLUTBScan<HeGrayTransformVol>(e2eImage, bscanImageConv, op.fillEmptyPixelWhite);
 					break;
 				case FileReadOptions::E2eGrayTransform::u16:
-					useLUTBScan<uint16_t, uint8_t, HeGrayTransformUFloat16>(e2eImage, bscanImageConv);
+					useLUTBScan<HeGrayTransformUFloat16>(e2eImage, bscanImageConv, op.fillEmptyPixelWhite);
 					break;
 				}
 				if(bscanImageConv.empty())
 				{
 					BOOST_LOG_TRIVIAL(error) << "E2E::copyBScan: Error: Converted Matrix empty, valid E2eGrayTransform option?";
-					useLUTBScan<uint16_t, uint8_t, HeGrayTransformXml>(e2eImage, bscanImageConv);
+					useLUTBScan<HeGrayTransformXml>(e2eImage, bscanImageConv, op.fillEmptyPixelWhite);
 				}
 			}
 
-			if(!op.fillEmptyPixelWhite)
-				fillEmptyBroderCols<uint8_t>(bscanImageConv, 255, 0);
-
 			transformImage(reg, bscanImageConv, op.fillEmptyPixelWhite);
 
 			std::shared_ptr<BScan> bscan = std::make_shared<BScan>(bscanImageConv, bscanData);
@@ -479,10 +417,36 @@ namespace OctData
 				cv::Mat angioImg = e2eAngioImg->getImage();
 // 				std::transform(angioImg.begin<uint8_t>(), angioImg.end<uint8_t>(), angioImg.begin<uint8_t>(), [](uint8_t v){ return v==255?0:v; });
 				if(reg)
-					transformImage(reg, angioImg, false, cv::INTER_NEAREST);
+					transformImage(reg, angioImg, false, false);
 				bscan->setAngioImage(angioImg);
 			}
-			series.addBScan(std::move(bscan));
+			return bscan;
+		}
+
+		void copyBScans(Series& series, const E2E::Series& e2eSeries, const FileReadOptions& op, CppFW::Callback& callbackSeries)
+		{
+			std::vector<const E2E::BScan*> e2eBScans;
+			e2eBScans.reserve(e2eSeries.size());
+			std::size_t bscanIndex = 0;
+			for(const E2E::Series::SubstructurePair& e2eBScanPair : e2eSeries)
+				if(op.seriesSelection.acceptBScan(bscanIndex++))
+					e2eBScans.push_back(&(*e2eBScanPair.second));
+
+			std::vector<std::shared_ptr<BScan>> bscans(e2eBScans.size());
+
+			CppFW::CallbackStepper bscanCallbackStepper(&callbackSeries, e2eBScans.size());
+			std::size_t steps = 0;
+			auto convertJob = [&](std::size_t index, std::size_t) { bscans[index] = convertBScan(series, *(e2eBScans[index]), op); };
+			auto progress   = [&](std::size_t finished)
+				{
+					for(; steps < finished; ++steps)
+						++bscanCallbackStepper;
+					return true;
+				};
+			parallelFor(e2eBScans.size(), op.numThreads, convertJob, progress);
+
+			bscans.erase(std::remove(bscans.begin(), bscans.end(), nullptr), bscans.end());
+			series.addBScans(std::move(bscans));
 		}
 		
 		std::string toLower(std::string data)
@@ -490,24 +454,60 @@ namespace OctData
 			std::transform(data.begin(), data.end(), data.begin(), [](char c){ return std::tolower(c); });
 			return data;
 		}
+
+		// patient files (pdb) and study files (edb) of a HEYEX database (sdb)
+		void readReferencedFiles(E2E::E2EData& e2eData, const bfs::path& file)
+		{
+			const E2E::DataRoot& e2eRoot = e2eData.getDataRoot();
+
+			BOOST_LOG_TRIVIAL(debug) << "Try to load extra files";
+			for(const E2E::DataRoot::SubstructurePair& e2ePatPair : e2eRoot)
+			{
+				const std::size_t bufferSize = 100;
+				char buffer[bufferSize];
+				const E2E::Patient& e2ePat = *(e2ePatPair.second);
+				std::snprintf(buffer, bufferSize, "%08d.pdb", e2ePatPair.first);
+
+				BOOST_LOG_TRIVIAL(debug) << "try to open patient informations file: " << buffer;
+				// std::string filenname =
+				bfs::path patientDataFile(file.parent_path() / buffer);
+				if(bfs::exists(patientDataFile))
+					e2eData.readE2EFile(patientDataFile.generic_string());
+
+				for(const E2E::Patient::SubstructurePair& e2eStudyPair : e2ePat)
+				{
+					std::snprintf(buffer, bufferSize, "%08d.edb", e2eStudyPair.first);
+					BOOST_LOG_TRIVIAL(debug) << "try to open series informations file: " << buffer;
+					bfs::path studyDataFile(file.parent_path() / buffer);
+					if(bfs::exists(studyDataFile))
+						e2eData.readE2EFile(studyDataFile.generic_string());
+				}
+			}
+		}
+
+		bool isHeyexFile(const FileReader& filereader)
+		{
+			const std::string fileExtLower = toLower(filereader.getFilepath().extension().generic_string());
+
+			if(!filereader.isSignatureMatch() && fileExtLower != ".e2e" && fileExtLower != ".sdb")
+				return false;
+
+			return bfs::exists(filereader.getFilepath());
+		}
 	}
 
 
 	HeE2ERead::HeE2ERead()
 	: OctFileReader({OctExtension(".E2E", "Heidelberg Engineering E2E File"), OctExtension(".sdb", "Heidelberg Engineering HEYEX File")})
 	{
+		addOptionalSignature(0, "CMDb");
 	}
 
-	bool HeE2ERead::readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* callback)
+	bool HeE2ERead::readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* callback) const
 	{
 		const std::filesystem::path& file = filereader.getFilepath();
-		
-		std::string fileExtLower = toLower(file.extension().generic_string());
-
-		if(fileExtLower != ".e2e" && fileExtLower != ".sdb")
-			return false;
 
-		if(!bfs::exists(file))
+		if(!isHeyexFile(filereader))
 			return false;
 
 		BOOST_LOG_TRIVIAL(trace) << "Try to open OCT file as HEYEX file";
@@ -521,8 +521,11 @@ namespace OctData
 			convertCallback = callback->createSubTask(0.5, 0.5);
 		}
 
+		const SeriesSelection& selection = op.seriesSelection;
+
+		// libE2E has only a switch for the B-scan images, the B-scan range is applied in copyBScans
 		E2E::E2EData e2eData;
-		e2eData.options.readBScanImages = op.readBScans;
+		e2eData.options.readBScanImages = op.readBScans && (selection.bscanEnd < 0 || selection.bscanEnd > selection.bscanBegin);
 		e2eData.readE2EFile(file.generic_string(), &loadCallback);
 
 		const E2E::DataRoot& e2eRoot = e2eData.getDataRoot();
@@ -532,31 +535,7 @@ namespace OctData
 
 		// load extra Data from patient file (pdb) and study file (edb)
 		if(file.extension() == ".sdb")
-		{
-			BOOST_LOG_TRIVIAL(debug) << "Try to load extra files";
-			for(const E2E::DataRoot::SubstructurePair& e2ePatPair : e2eRoot)
-			{
-				const std::size_t bufferSize = 100;
-				char buffer[bufferSize];
-				const E2E::Patient& e2ePat = *(e2ePatPair.second);
-				std::snprintf(buffer, bufferSize, "%08d.pdb", e2ePatPair.first);
-
-				BOOST_LOG_TRIVIAL(debug) << "try to open patient informations file: " << buffer;
-				// std::string filenname =
-				bfs::path patientDataFile(file.parent_path() / buffer);
-				if(bfs::exists(patientDataFile))
-					e2eData.readE2EFile(patientDataFile.generic_string());
-
-				for(const E2E::Patient::SubstructurePair& e2eStudyPair : e2ePat)
-				{
-					std::snprintf(buffer, bufferSize, "%08d.edb", e2eStudyPair.first);
-					BOOST_LOG_TRIVIAL(debug) << "try to open series informations file: " << buffer;
-					bfs::path studyDataFile(file.parent_path() / buffer);
-					if(bfs::exists(studyDataFile))
-						e2eData.readE2EFile(studyDataFile.generic_string());
-				}
-			}
-		}
+			readReferencedFiles(e2eData, file);
 
 
 		BOOST_LOG_TRIVIAL(debug) << "convert HEYEX data to own data structure";
@@ -572,8 +551,19 @@ namespace OctData
 			if(e2ePat.getCreateFromLoadedFileNum() != basisFileId)
 				continue;
 
-			Patient& pat = oct.getPatient(e2ePatPair.first);
-			copyPatData(pat, e2ePat);
+			// with a series selection, patients and studies are only created for selected series
+			Patient* pat = nullptr;
+			auto getPatient = [&]() -> Patient&
+				{
+					if(!pat)
+					{
+						pat = &oct.getPatient(e2ePatPair.first);
+						copyPatData(*pat, e2ePat);
+					}
+					return *pat;
+				};
+			if(selection.selectsAllSeries())
+				getPatient();
 			
 			for(const E2E::Patient::SubstructurePair& e2eStudyPair : e2ePat)
 			{
@@ -586,9 +576,20 @@ namespace OctData
 					continue;
 
 // 				std::cout << "studyID: " << studyID << std::endl;
-				Study& study = pat.getStudy(e2eStudyPair.first);
-
-				copyStudyData(study, e2eStudy);
+				Study* study = nullptr;
+				auto getStudy = [&]() -> Study&
+					{
+						if(!study)
+						{
+							study = &getPatient().getStudy(e2eStudyPair.first);
+							copyStudyData(*study, e2eStudy);
+						}
+						return *study;
+					};
+				if(selection.selectsAllSeries())
+					getStudy();
+
+				const Date studyDate = getStudyDate(e2eStudy);
 
 				
 				for(const E2E::Study::SubstructurePair& e2eSeriesPair : e2eStudy)
@@ -599,18 +600,16 @@ namespace OctData
 					if(e2eSeries.getCreateFromLoadedFileNum() != basisFileId)
 						continue;
 
+					if(!isSeriesSelected(selection, e2eSeriesPair.first, e2eSeries, studyDate))
+						continue;
+
 // 					std::cout << "seriesID: " << seriesID << std::endl;
-					Series& series = study.getSeries(e2eSeriesPair.first);
+					Series& series = getStudy().getSeries(e2eSeriesPair.first);
 					copySlo(series, e2eSeries, op);
 					
 					copySeriesData(series, e2eSeries);
 
-					CppFW::CallbackStepper bscanCallbackStepper(&callbackSeries, e2eSeries.size());
-					for(const E2E::Series::SubstructurePair& e2eBScanPair : e2eSeries)
-					{
-						copyBScan(series, *(e2eBScanPair.second), op);
-						++bscanCallbackStepper;
-					}
+					copyBScans(series, e2eSeries, op, callbackSeries);
 				}
 			}
 		}
@@ -620,5 +619,70 @@ namespace OctData
 		return true;
 	}
 
+	bool HeE2ERead::scanMetadata(FileReader& filereader, OctMetadata& metadata, const FileReadOptions& op) const
+	{
+		const std::filesystem::path& file = filereader.getFilepath();
+
+		if(!isHeyexFile(filereader))
+			return false;
+
+		// the structure and the metadata elements, without decoding the B-scan images
+		E2E::E2EData e2eData;
+		e2eData.options.readBScanImages = false;
+		e2eData.readE2EFile(file.generic_string());
+
+		const E2E::DataRoot& e2eRoot = e2eData.getDataRoot();
+		const std::size_t basisFileId = e2eRoot.getCreateFromLoadedFileNum();
+
+		if(file.extension() == ".sdb")
+			readReferencedFiles(e2eData, file);
+
+		for(const E2E::DataRoot::SubstructurePair& e2ePatPair : e2eRoot)
+		{
+			const E2E::Patient& e2ePat = *(e2ePatPair.second);
+			if(e2ePat.getCreateFromLoadedFileNum() != basisFileId)
+				continue;
+
+			Patient pat(e2ePatPair.first);
+			copyPatData(pat, e2ePat);
+
+			for(const E2E::Patient::SubstructurePair& e2eStudyPair : e2ePat)
+			{
+				const E2E::Study& e2eStudy = *(e2eStudyPair.second);
+				if(e2eStudy.getCreateFromLoadedFileNum() != basisFileId)
+					continue;
+
+				Study study(e2eStudyPair.first);
+				copyStudyData(study, e2eStudy);
+
+				for(const E2E::Study::SubstructurePair& e2eSeriesPair : e2eStudy)
+				{
+					const E2E::Series& e2eSeries = *(e2eSeriesPair.second);
+					if(e2eSeries.getCreateFromLoadedFileNum() != basisFileId)
+						continue;
+
+					if(!isSeriesSelected(op.seriesSelection, e2eSeriesPair.first, e2eSeries, study.getStudyDate()))
+						continue;
+
+					Series series(e2eSeriesPair.first);
+					copySeriesData(series, e2eSeries);
+
+					// B-scan nodes, the size of the B-scans is only known from the images
+					SeriesMetadata& entry = metadata.addSeries(pat, study, series);
+					entry.numBScans = e2eSeries.size();
+
+					const E2E::Image* e2eSlo = e2eSeries.getSloImage();
+					if(e2eSlo)
+					{
+						entry.sloWidth  = e2eSlo->getImageCols();
+						entry.sloHeight = e2eSlo->getImageRows();
+					}
+				}
+			}
+		}
+
+		return true;
+	}
+
 
 }
@@ -8,29 +8,6 @@
 
 namespace OctData
 {
-	HeGrayTransformXml::HeGrayTransformXml()
-	: lutXML(new uint8_t[1 << sizeof(uint16_t)*8])
-	{
-		uint8_t* lutXmlIt = lutXML;
-		for(int i = 0; i <= std::numeric_limits<char16_t>::max(); ++i)
-		{
-			*lutXmlIt = getXmlValue(static_cast<char16_t>(i));
-			++lutXmlIt;
-		}
-	}
-
-
-	HeGrayTransformUFloat16::HeGrayTransformUFloat16()
-	: lut(new uint8_t[1 << sizeof(uint16_t)*8])
-	{
-		uint8_t* lutIt = lut;
-		for(int i = 0; i <= std::numeric_limits<char16_t>::max(); ++i)
-		{
-			*lutIt = getUint8Value(static_cast<char16_t>(i));
-			++lutIt;
-		}
-	}
-
 	double HeGrayTransformUFloat16::getDoubleValue(uint16_t val)
 	{
 		int mat = val & ((1<<10)-1);
@@ -54,15 +31,17 @@ namespace OctData
 
 
 
-	HeGrayTransformVol::HeGrayTransformVol()
-	: lutVol(new uint8_t[1 << sizeof(uint16_t)*8])
+	uint8_t HeGrayTransformNativ::getNativValue(uint16_t val)
 	{
-		uint8_t* lutVolIt = lutVol;
-		for(int i = 0; i <= std::numeric_limits<char16_t>::max(); ++i)
-		{
-			*lutVolIt = getVolValue(static_cast<char16_t>(i));
-			++lutVolIt;
-		}
+		// float calculation and rounding like convertTo(CV_32F), cv::pow(…, 8) (squaring) and convertTo(CV_8U, 255)
+		float v = static_cast<float>(val)*(1.f/static_cast<float>(1 << 16));
+		v *= v;
+		v *= v;
+		v *= v;
+		const long result = std::lrint(v*255.f);
+		if(result > 255)
+			return 255;
+		return static_cast<uint8_t>(result);
 	}
 
 
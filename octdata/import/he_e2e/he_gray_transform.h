@@ -5,37 +5,24 @@
 
 namespace OctData
 {
+	// tables with lut16To8TableSize entries, generated at build time from the value functions (tablegen/he_gray_tablegen.cpp)
+	extern const uint8_t heGrayTransformXmlLUT[];
+	extern const uint8_t heGrayTransformVolLUT[];
+	extern const uint8_t heGrayTransformUFloat16LUT[];
+	extern const uint8_t heGrayTransformNativLUT[];
 
 	class HeGrayTransformXml
 	{
-		uint8_t* lutXML = nullptr;
-
-		HeGrayTransformXml();
-		~HeGrayTransformXml()                                    { delete[] lutXML; }
-
-		HeGrayTransformXml(const HeGrayTransformXml&)            = delete;
-		HeGrayTransformXml& operator=(const HeGrayTransformXml&) = delete;
-
 	public:
-		static HeGrayTransformXml& getInstance()                 { static HeGrayTransformXml instance; return instance; }
 		static uint8_t getXmlValue(uint16_t val);
 
-		uint8_t getValue(uint16_t val) const                     { return lutXML[val]; }
-		
+		static uint8_t getValue(uint16_t val)                    { return heGrayTransformXmlLUT[val]; }
+		static const uint8_t* getLUT()                           { return heGrayTransformXmlLUT; }
 	};
 
 	class HeGrayTransformVol
 	{
-		uint8_t* lutVol = nullptr;
-
-		HeGrayTransformVol();
-		~HeGrayTransformVol()                                    { delete[] lutVol; }
-
-		HeGrayTransformVol(const HeGrayTransformVol&)            = delete;
-		HeGrayTransformVol& operator=(const HeGrayTransformVol&) = delete;
-
 	public:
-		static HeGrayTransformVol& getInstance()                 { static HeGrayTransformVol instance; return instance; }
 		static uint8_t getVolValue(uint16_t val)
 		{
 			const double fitVal1 = 2.38423154996781e-07;
@@ -50,26 +37,28 @@ namespace OctData
 			return static_cast<uint8_t>(tmpVal * 255);
 		}
 
-		uint8_t getValue(uint16_t val) const                     { return lutVol[val]; }
+		static uint8_t getValue(uint16_t val)                    { return heGrayTransformVolLUT[val]; }
+		static const uint8_t* getLUT()                           { return heGrayTransformVolLUT; }
 	};
 
 	class HeGrayTransformUFloat16
 	{
-		uint8_t* lut = nullptr;
-
-		HeGrayTransformUFloat16();
-		~HeGrayTransformUFloat16()                                    { delete[] lut; }
-
-		HeGrayTransformUFloat16(const HeGrayTransformXml&)            = delete;
-		HeGrayTransformUFloat16& operator=(const HeGrayTransformXml&) = delete;
-
 	public:
-		static HeGrayTransformUFloat16& getInstance()                 { static HeGrayTransformUFloat16 instance; return instance; }
 		static uint8_t getUint8Value(uint16_t val);
 		static double  getDoubleValue(uint16_t val);
 
-		uint8_t getValue(uint16_t val) const                     { return lut[val]; }
+		static uint8_t getValue(uint16_t val)                    { return heGrayTransformUFloat16LUT[val]; }
+		static const uint8_t* getLUT()                           { return heGrayTransformUFloat16LUT; }
+	};
+
+	// (val/2^16)^8 * 255, the former float conversion with cv::pow as table
+	class HeGrayTransformNativ
+	{
+	public:
+		static uint8_t getNativValue(uint16_t val);
 
+		static uint8_t getValue(uint16_t val)                    { return heGrayTransformNativLUT[val]; }
+		static const uint8_t* getLUT()                           { return heGrayTransformNativLUT; }
 	};
 
 }
@@ -3,9 +3,12 @@
 #include <datastruct/coordslo.h>
 #include <datastruct/sloimage.h>
 #include <datastruct/bscan.h>
+#include <datastruct/bscanimagecache.h>
+#include <datastruct/octmetadata.h>
 
 #include <ostream>
 #include <thread>
+#include <mutex>
 #include <chrono>
 #include <ctime>
 #include<filesystem>
@@ -18,7 +21,7 @@
 #include <boost/log/trivial.hpp>
 #include <boost/lexical_cast.hpp>
 
-#include <emmintrin.h>
+#include <imgproc/quadrootconvert.h>
 #include <oct_cpp_framework/callback.h>
 
 #include<boost/optional.hpp>
@@ -121,10 +124,10 @@ namespace
 		}
 
 		std::size_t getSLOPixelSize() const   {
-			return data.sizeXSlo*data.sizeYSlo;
+			return static_cast<std::size_t>(data.sizeXSlo)*data.sizeYSlo;
 		}
 		std::size_t getBScanPixelSize() const {
-			return data.sizeX   *data.sizeZ   *sizeof(float);
+			return static_cast<std::size_t>(data.sizeX)   *data.sizeZ   *sizeof(float);
 		}
 		std::size_t getBScanSize() const      {
 			return getBScanPixelSize() + data.bScanHdrSize;
@@ -134,6 +137,18 @@ namespace
 			return 2048;
 		}
 
+		// number of complete B-scans in a file of fileSize bytes, the header values are not trusted
+		std::size_t getNumBScansInFile(std::size_t fileSize) const {
+			const std::size_t begin = getHeaderSize() + getSLOPixelSize();
+			if(fileSize <= begin || data.sizeX == 0 || data.sizeZ == 0)
+				return 0;
+
+			const std::size_t available = fileSize - begin;
+			if(data.sizeX > available/sizeof(float)/data.sizeZ)
+				return 0;
+			return available/getBScanSize();
+		}
+
 	};
 
 	struct BScanHeader
@@ -235,39 +250,100 @@ namespace
 	}
 
 
-	void simdQuadRoot(const cv::Mat& in, cv::Mat& out)
+	// opens the file and reads the header, the read position is behind the header
+	bool openVolFile(OctData::FileReader& filereader, VolHeader& volHeader)
 	{
-		if(in.type() == cv::DataType<float>::type)
+		const std::string filename = filereader.getFilepath().generic_string();
+
+		if(!filereader.openFile())
+		{
+			BOOST_LOG_TRIVIAL(error) << "Can't open vol file " << filename;
+			return false;
+		}
+/*
+		std::fstream stream(filepathConv(file), std::ios::binary | std::ios::in);
+		if(!stream.good())
 		{
-			out.create(in.size(), in.type());
+			BOOST_LOG_TRIVIAL(error) << "Can't open vol file " << filepathConv(file);
+			return false;
+		}
+		*/
 
-			std::size_t size = in.rows*in.cols;
-			const float* dataPtr = in .ptr<float>(0);
-			      float* outPtr  = out.ptr<float>(0);
+		BOOST_LOG_TRIVIAL(debug) << "open " << filename << " as vol file";
 
-			// SIMD
-			std::size_t nb_iters = size / 4;
-			const __m128* ptr = reinterpret_cast<const __m128*>(dataPtr);
-			for(std::size_t i = 0; i < nb_iters; ++i)
-			{
-				_mm_store_ps(outPtr, _mm_sqrt_ps(_mm_sqrt_ps(*ptr)));
-				++ptr;
-				outPtr  += 4;
-			}
 
-			// handel rest
-			outPtr = out.ptr<float>(0);
+		const std::size_t formatstringlength = 8;
+		char fileformatstring[formatstringlength];
+		filereader.readFStream(fileformatstring, formatstringlength);
+		if(memcmp(fileformatstring, "HSF-OCT-", formatstringlength) != 0) // 0 = strings are equal
+		{
+			BOOST_LOG_TRIVIAL(error) << filename << " Wrong fileformat (not HSF-OCT)";
+			return false;
+		}
 
-			for(std::size_t pos = nb_iters*4; pos<size; ++pos)
-			{
-				outPtr[pos] = std::sqrt(std::sqrt(dataPtr[pos]));
-			}
+		filereader.readFStream(&(volHeader.data));
+// 		volHeader.printData(std::cout);
+		BOOST_LOG_TRIVIAL(info) << "HSF file version: " << volHeader.data.version;
+		filereader.seekg(VolHeader::getHeaderSize());
+		return true;
+	}
+
+	// float B-scan from the file to 8 bit, rawImage is the (truncated) float image (only with holdRawData)
+	void convertBScanImage(const cv::Mat& bscanImage, bool fillEmptyPixelWhite, bool holdRawData, cv::Mat& bscanImageConv, cv::Mat& rawImage)
+	{
+		// fillEmptyPixelWhite: schneide hohe werte ab, sonst: bei der konvertierung werden sie auf 0 gesetzt
+		quadRootToUInt8(bscanImage, bscanImageConv, fillEmptyPixelWhite ? OctData::QuadRootInput::truncateOne : OctData::QuadRootInput::plain);
+
+		if(!holdRawData)
+			return;
+
+		if(fillEmptyPixelWhite)
+		{
+			cv::Mat bscanImageTrunc; // not in place, bscanImage can be on the file mapping
+			cv::threshold(bscanImage, bscanImageTrunc, 1.0, 1.0, cv::THRESH_TRUNC);
+			rawImage = bscanImageTrunc;
 		}
 		else
+			rawImage = bscanImage;
+	}
+
+	// reads the B-scan images on demand (FileReadOptions::lazyBScans)
+	class VolLazyBScanSource
+	{
+		std::mutex          mutex;
+		OctData::FileReader filereader;
+
+		const bool        fillEmptyPixelWhite;
+		const bool        holdRawData;
+		const std::size_t sizeX;
+		const std::size_t sizeZ;
+
+	public:
+		VolLazyBScanSource(const std::filesystem::path& file, const OctData::FileReadOptions& op, const VolHeader& header)
+		: filereader         (file)
+		, fillEmptyPixelWhite(op.fillEmptyPixelWhite)
+		, holdRawData        (op.holdRawData)
+		, sizeX              (header.data.sizeX)
+		, sizeZ              (header.data.sizeZ)
+		{}
+
+		bool open()                                                { return filereader.openFile(); }
+
+		void loadBScan(std::size_t imagePos, cv::Mat& image, cv::Mat& rawImage)
 		{
-			cv::pow(in, 0.25, out);
+			cv::Mat bscanImage;
+			{
+				std::lock_guard<std::mutex> lock(mutex); // read position of the file
+				filereader.mapCVImage<float>(bscanImage, imagePos, sizeZ, sizeX);
+			}
+
+			convertBScanImage(bscanImage, fillEmptyPixelWhite, holdRawData, image, rawImage);
+
+			// the B-scan hands out copies of the header, the raw image must not point into the file mapping
+			if(rawImage.data == bscanImage.data)
+				rawImage = bscanImage.clone();
 		}
-	}
+	};
 }
 
 
@@ -277,9 +353,10 @@ namespace OctData
 	VOLRead::VOLRead()
 	: OctFileReader(OctExtension{".vol", ".vol.gz", "Heidelberg Engineering Raw File"})
 	{
+		addSignature(0, "HSF-OCT-");
 	}
 
-	bool VOLRead::readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* callback)
+	bool VOLRead::readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* callback) const
 	{
 //
 //     BOOST_LOG_TRIVIAL(trace) << "A trace severity message";
@@ -289,44 +366,15 @@ namespace OctData
 //     BOOST_LOG_TRIVIAL(error) << "An error severity message";
 //     BOOST_LOG_TRIVIAL(fatal) << "A fatal severity message";
 
-		if(filereader.getExtension() != ".vol")
+		if(!filereader.isSignatureMatch() && filereader.getExtension() != ".vol")
 			return false;
 
 		const std::string filename = filereader.getFilepath().generic_string();
 		BOOST_LOG_TRIVIAL(trace) << "Try to open OCT file as vol";
 
-		if(!filereader.openFile())
-		{
-			BOOST_LOG_TRIVIAL(error) << "Can't open vol file " << filename;
-			return false;
-		}
-/*
-		std::fstream stream(filepathConv(file), std::ios::binary | std::ios::in);
-		if(!stream.good())
-		{
-			BOOST_LOG_TRIVIAL(error) << "Can't open vol file " << filepathConv(file);
-			return false;
-		}
-		*/
-
-		BOOST_LOG_TRIVIAL(debug) << "open " << filename << " as vol file";
-
-
-		const std::size_t formatstringlength = 8;
-		char fileformatstring[formatstringlength];
-		filereader.readFStream(fileformatstring, formatstringlength);
-		if(memcmp(fileformatstring, "HSF-OCT-", formatstringlength) != 0) // 0 = strings are equal
-		{
-			BOOST_LOG_TRIVIAL(error) << filename << " Wrong fileformat (not HSF-OCT)";
-			return false;
-		}
-
 		VolHeader volHeader;
-
-		filereader.readFStream(&(volHeader.data));
-// 		volHeader.printData(std::cout);
-		BOOST_LOG_TRIVIAL(info) << "HSF file version: " << volHeader.data.version;
-		filereader.seekg(VolHeader::getHeaderSize());
+		if(!openVolFile(filereader, volHeader))
+			return false;
 
 		Patient& pat    = oct.getPatient(volHeader.data.pid);
 		Study&   study  = pat.getStudy(volHeader.data.vid);
@@ -337,8 +385,10 @@ namespace OctData
 
 
 		// Read SLO
+		bool useFileMapping = false;
 		cv::Mat sloImage;
-		filereader.readCVImage<uint8_t>(sloImage, volHeader.data.sizeXSlo, volHeader.data.sizeYSlo);
+		if(op.readSlo && filereader.mapCVImage<uint8_t>(sloImage, VolHeader::getHeaderSize(), volHeader.data.sizeXSlo, volHeader.data.sizeYSlo))
+			useFileMapping = true;
 
 		{
 			std::unique_ptr<SloImage> slo = std::make_unique<SloImage>();
@@ -348,14 +398,57 @@ namespace OctData
 		}
 
 
-		const std::size_t numBScans = op.readBScans?volHeader.data.numBScans:1;
+		std::size_t firstBScan = 0;
+		std::size_t endBScan   = op.readBScans?volHeader.data.numBScans:1;
+		if(op.readBScanNum >= 0)
+		{
+			firstBScan = std::min(static_cast<std::size_t>(op.readBScanNum), static_cast<std::size_t>(volHeader.data.numBScans));
+			endBScan   = std::min(firstBScan + 1                           , static_cast<std::size_t>(volHeader.data.numBScans));
+		}
+		const std::size_t numBScans = volHeader.data.numBScans;
+
+		// checked before the volume and the B-scan list are allocated from the header sizes
+		const std::size_t numBScansInFile = volHeader.getNumBScansInFile(filereader.file_size());
+		if(endBScan > numBScansInFile)
+		{
+			if(firstBScan >= numBScansInFile)
+			{
+				BOOST_LOG_TRIVIAL(error) << filename << ": B-scan " << firstBScan << " behind the end of the file (header: " << numBScans << " B-scans "
+				                         << volHeader.data.sizeX << "x" << volHeader.data.sizeZ << ")";
+				return false;
+			}
+			BOOST_LOG_TRIVIAL(warning) << filename << ": file holds " << numBScansInFile << " of " << numBScans << " B-scans";
+			endBScan = numBScansInFile;
+		}
+
+		std::shared_ptr<VolLazyBScanSource> lazySource;
+		std::shared_ptr<BScanImageCache>    lazyCache;
+		if(op.lazyBScans)
+		{
+			lazySource = std::make_shared<VolLazyBScanSource>(filereader.getFilepath(), op, volHeader);
+			if(!lazySource->open())
+			{
+				BOOST_LOG_TRIVIAL(error) << "Can't open vol file " << filename << " for lazy loading";
+				return false;
+			}
+			if(op.bscanCacheSize > 0)
+				lazyCache = std::make_shared<BScanImageCache>(static_cast<std::size_t>(op.bscanCacheSize));
+		}
+
+		// the converted B-scans are views into one contiguous volume
+		if(!lazySource && endBScan > firstBScan)
+			series.createVolume(static_cast<int>(endBScan - firstBScan), static_cast<int>(volHeader.data.sizeZ), static_cast<int>(volHeader.data.sizeX), cv::DataType<uint8_t>::type);
+
 		// Read BScann
-		for(std::size_t numBscan = 0; numBscan<numBScans; ++numBscan)
+		std::size_t numBScansRead = 0;
+		std::vector<std::shared_ptr<BScan>> bscans;
+		bscans.reserve(endBScan - firstBScan);
+		for(std::size_t numBscan = firstBScan; numBscan<endBScan; ++numBscan)
 		{
 // 			std::this_thread::sleep_for(std::chrono::milliseconds(50));
 			if(callback)
 			{
-				if(!callback->callback(static_cast<double>(numBscan)/static_cast<double>(numBScans)))
+				if(!callback->callback(static_cast<double>(numBscan-firstBScan)/static_cast<double>(endBScan-firstBScan)))
 				{
 					BOOST_LOG_TRIVIAL(info) << "loading canceled by user";
 					return false;
@@ -426,22 +519,12 @@ namespace OctData
 					bscanData.getSegmentLine(*(seglines[segNum])) = std::move(segVec);
 			}
 
-			filereader.seekg(volHeader.data.bScanHdrSize+bscanPos);
-			cv::Mat bscanImage;
-			cv::Mat bscanImagePow;
-			cv::Mat bscanImageConv;
-			filereader.readCVImage<float>(bscanImage, volHeader.data.sizeZ, volHeader.data.sizeX);
-
-			if(op.fillEmptyPixelWhite)
-				cv::threshold(bscanImage, bscanImage, 1.0, 1.0, cv::THRESH_TRUNC); // schneide hohe werte ab, sonst: bei der konvertierung werden sie auf 0 gesetzt
-			// cv::pow(bscanImage, 0.25, bscanImagePow);
-			simdQuadRoot(bscanImage, bscanImagePow);
-			bscanImagePow.convertTo(bscanImageConv, CV_8U, 255, 0);
+			const std::size_t imagePos = volHeader.data.bScanHdrSize+bscanPos;
 
 			bscanData.start       = CoordSLOmm(bscanHeader.data.startX, bscanHeader.data.startY);
 
 			if(series.getScanPattern() == OctData::Series::ScanPattern::Circular
-			|| (series.getScanPattern() == OctData::Series::ScanPattern::RadialCircles && numBscan >= numBScans-3)) // specific to the ScanPattern
+			|| (series.getScanPattern() == OctData::Series::ScanPattern::RadialCircles && numBscan+3 >= numBScans)) // specific to the ScanPattern
 			{
 				bscanData.bscanType         = BScan::BScanType::Circle;
 				bscanData.center            = CoordSLOmm(bscanHeader.data.endX  , bscanHeader.data.endY  );
@@ -458,14 +541,44 @@ namespace OctData
 			bscanData.imageQuality = bscanHeader.data.quality;
 
 
+			if(lazySource)
+			{
+				if(!filereader.good())
+					break;
+				BScan::ImageLoader loader = [lazySource, imagePos](cv::Mat& image, cv::Mat& rawImage) { lazySource->loadBScan(imagePos, image, rawImage); };
+				bscans.push_back(std::make_shared<BScan>(loader, static_cast<int>(volHeader.data.sizeX), static_cast<int>(volHeader.data.sizeZ), bscanData, lazyCache));
+				continue;
+			}
+
+			cv::Mat bscanImage;
+			cv::Mat bscanImageRaw;
+			cv::Mat bscanImageConv = series.getVolumeSlice(static_cast<int>(numBScansRead));
+			const bool bscanMapped = filereader.mapCVImage<float>(bscanImage, imagePos, volHeader.data.sizeZ, volHeader.data.sizeX);
+			convertBScanImage(bscanImage, op.fillEmptyPixelWhite, op.holdRawData, bscanImageConv, bscanImageRaw);
+
 			if(!filereader.good())
 				break;
 
 			std::shared_ptr<BScan> bscan = std::make_shared<BScan>(bscanImageConv, bscanData);
 			if(op.holdRawData)
-				bscan->setRawImage(bscanImage);
-			series.addBScan(std::move(bscan));
+			{
+				bscan->setRawImage(bscanImageRaw);
+				useFileMapping |= bscanMapped && !op.fillEmptyPixelWhite;
+			}
+			bscans.push_back(std::move(bscan));
+			++numBScansRead;
 		}
+		series.addBScans(std::move(bscans));
+
+		if(series.hasVolume() && static_cast<int>(numBScansRead) < series.getVolume().size[0])
+		{
+			// incomplete file, only the read B-scans
+			const cv::Range ranges[] = { cv::Range(0, static_cast<int>(numBScansRead)), cv::Range::all(), cv::Range::all() };
+			series.setVolume(numBScansRead > 0 ? series.getVolume()(ranges) : cv::Mat());
+		}
+
+		if(useFileMapping)
+			oct.holdFileMapping(filereader.getMappingOwner());
 
 		if(volHeader.data.gridType > 0 && volHeader.data.gridOffset > 2000)
 		{
@@ -486,4 +599,27 @@ namespace OctData
 		return true;
 	}
 
+	bool VOLRead::scanMetadata(FileReader& filereader, OctMetadata& metadata, const FileReadOptions& /*op*/) const
+	{
+		if(!filereader.isSignatureMatch() && filereader.getExtension() != ".vol")
+			return false;
+
+		VolHeader volHeader;
+		if(!openVolFile(filereader, volHeader))
+			return false;
+
+		Patient pat   (static_cast<int>(volHeader.data.pid));
+		Study   study (static_cast<int>(volHeader.data.vid));
+		Series  series(1);
+		copyMetaData(volHeader, pat, study, series);
+
+		SeriesMetadata& entry = metadata.addSeries(pat, study, series);
+		entry.numBScans   = volHeader.data.numBScans;
+		entry.bscanWidth  = static_cast<int>(volHeader.data.sizeX);
+		entry.bscanHeight = static_cast<int>(volHeader.data.sizeZ);
+		entry.sloWidth    = static_cast<int>(volHeader.data.sizeXSlo);
+		entry.sloHeight   = static_cast<int>(volHeader.data.sizeYSlo);
+		return true;
+	}
+
 }
@@ -10,7 +10,8 @@ namespace OctData
 	public:
 		VOLRead();
 
-	    virtual bool readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* callback) override;
+	    virtual bool readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* callback) const override;
+	    virtual bool scanMetadata(FileReader& filereader, OctMetadata& metadata, const FileReadOptions& op) const override;
 	};
 }
 
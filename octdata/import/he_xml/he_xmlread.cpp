@@ -170,7 +170,7 @@ namespace OctData
 			series.setRefSeriesUID(readOptinalNode<std::string>(seriesNode, "ReferenceSeries.SeriesUID", std::string()));
 		}
 
-		void fillBScann(const bpt::ptree& imageNode, const bpt::ptree& studyNode, Series& series, const std::string& xmlPath)
+		std::shared_ptr<BScan> readBScann(const bpt::ptree& imageNode, const bpt::ptree& studyNode, const std::string& xmlPath)
 		{
 			BScan::Data bscanData;
 
@@ -213,8 +213,7 @@ namespace OctData
 					bscanData.acquisitionTime = readDateTime(*studyDateNode, *imageTimeNode);
 			}
 
-			series.addBScan(std::make_unique<BScan>(image, bscanData));
-
+			return std::make_shared<BScan>(image, bscanData);
 		}
 
 	}
@@ -226,7 +225,7 @@ namespace OctData
 	{
 	}
 
-	bool HeXmlRead::readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* callback)
+	bool HeXmlRead::readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* callback) const
 	{
 		const std::filesystem::path& file = filereader.getFilepath();
 		if(file.extension() != ".xml")
@@ -311,6 +310,7 @@ namespace OctData
 
 			const std::size_t numberOfSeriesNodes = seriesStudyNode.size();
 			      std::size_t actSeriesNodeNum    = 0;
+			std::vector<std::shared_ptr<BScan>> bscans;
 			for(const std::pair<const std::string, bpt::ptree>& imageNode : seriesStudyNode)
 			{
 				++actSeriesNodeNum;
@@ -340,10 +340,11 @@ namespace OctData
 				}
 
 				if(typeStr == "OCT" && op.readBScans)
-					fillBScann(imageNode.second, studyNode, series, xmlPath);
+					bscans.push_back(readBScann(imageNode.second, studyNode, xmlPath));
 
 
 			}
+			series.addBScans(std::move(bscans));
 		}
 		return true;
 	}
@@ -11,12 +11,9 @@ namespace OctData
 	
 	class HeXmlRead : public OctFileReader
 	{
-		std::filesystem::path xmlFilename;
-		std::filesystem::path xmlPath;
-
 	public:
 		HeXmlRead();
 
-		virtual bool readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* callback) override;
+		virtual bool readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* callback) const override;
 	};
 }
@@ -21,6 +21,7 @@
 #include <boost/lexical_cast.hpp>
 
 #include<filereader/filereader.h>
+#include<filereader/filestreambuf.h>
 
 namespace bfs = std::filesystem;
 
@@ -334,7 +335,11 @@ namespace
 						return;
 				}
 
-				std::shared_ptr<OctData::BScan> bscan = std::make_shared<OctData::BScan>(viewImage.t(), bscanData);
+				// view into the series volume, own image for frames behind the frame count of the header
+				cv::Mat bscanImage = series.getVolumeSlice(static_cast<int>(series.bscanCount()));
+				cv::transpose(viewImage, bscanImage);
+
+				std::shared_ptr<OctData::BScan> bscan = std::make_shared<OctData::BScan>(bscanImage, bscanData);
 				if(op.holdRawData && !rawImage.empty())
 					bscan->setRawImage(rawImage);
 				series.addBScan(std::move(bscan));
@@ -363,8 +368,24 @@ namespace
 		const OctData::FileReadOptions& op;
 		CppFW::CallbackStepper& callbackStepper;
 		DictFrameHeader dictFrameHeader;
+		const std::size_t fileSize;
+
+		// the frame header is not trusted, the volume is only allocated if the file can hold all frames
+		bool framesFitInFile(std::size_t bytesPerSample) const
+		{
+			const std::size_t framecount = dictFrameHeader.getFramecount();
+			const std::size_t linecount  = dictFrameHeader.getLinecount ();
+			const std::size_t linelength = dictFrameHeader.getLinelength();
+			if(framecount == 0 || linecount == 0 || linelength == 0)
+				return false;
+
+			const std::size_t maxPixel = fileSize/bytesPerSample;
+			return linelength <= maxPixel/linecount && framecount <= maxPixel/(linecount*linelength);
+		}
+
 	public:
-		MainDict(OctData::Series& series, const OctData::FileReadOptions& op, CppFW::CallbackStepper& callbackStepper) : series(series), op(op), callbackStepper(callbackStepper) {}
+		MainDict(OctData::Series& series, const OctData::FileReadOptions& op, CppFW::CallbackStepper& callbackStepper, std::size_t fileSize)
+		: series(series), op(op), callbackStepper(callbackStepper), fileSize(fileSize) {}
 
 		void handelDictEntry(std::istream& stream, const std::string& name, std::size_t& readedBytes)
 		{
@@ -384,6 +405,19 @@ namespace
 				readedBytes += readDict(stream, dictFrameHeader, dictLength);
 				dictFrameHeader.print(std::cout);
 				dictFrameHeader.copyData(series);
+
+				const uint32_t sampleformat = dictFrameHeader.getSampleformat();
+				if(sampleformat == 1 || sampleformat == 2)
+				{
+					if(framesFitInFile(sampleformat))
+						series.createVolume(static_cast<int>(dictFrameHeader.getFramecount())
+						                  , static_cast<int>(dictFrameHeader.getLinelength())
+						                  , static_cast<int>(dictFrameHeader.getLinecount ())
+						                  , cv::DataType<uint8_t>::type);
+					else
+						BOOST_LOG_TRIVIAL(warning) << "Frame header (" << dictFrameHeader.getFramecount() << " frames " << dictFrameHeader.getLinelength() << "x" << dictFrameHeader.getLinecount()
+						                           << ") larger than the file, frames are read one by one";
+				}
 			}
 			else
 			{
@@ -405,9 +439,10 @@ namespace OctData
 	OctFileFormatRead::OctFileFormatRead()
 	: OctFileReader(OctExtension(".OCT", "Bioptigen Oct file"))
 	{
+		addSignature(0, std::string("\xa5\xa7\x7d\x0c", 4));
 	}
 
-	bool OctFileFormatRead::readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* callback)
+	bool OctFileFormatRead::readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* callback) const
 	{
 		const std::filesystem::path& file = filereader.getFilepath();
 //
@@ -418,21 +453,21 @@ namespace OctData
 //     BOOST_LOG_TRIVIAL(error) << "An error severity message";
 //     BOOST_LOG_TRIVIAL(fatal) << "A fatal severity message";
 
-		if(file.extension() != ".OCT")
+		if(!filereader.isSignatureMatch() && file.extension() != ".OCT")
 			return false;
 
 		BOOST_LOG_TRIVIAL(trace) << "Try to open OCT file as Bioptigen oct file";
 
-		boost::uintmax_t filesize = file_size(file);
-		CppFW::CallbackStepper callbackStepper(callback, filesize);
-
-
-		std::fstream stream(file, std::ios::binary | std::ios::in);
-		if(!stream.good())
+		if(!filereader.openFile())
 		{
 			BOOST_LOG_TRIVIAL(error) << "Can't open oct file " << file;
 			return false;
 		}
+		FileStreamBuf streamBuf(filereader, static_cast<std::size_t>(std::max(op.readBufferSize, 0)));
+		std::istream stream(&streamBuf);
+
+		const std::size_t filesize = filereader.file_size();
+		CppFW::CallbackStepper callbackStepper(callback, filesize);
 
 		BOOST_LOG_TRIVIAL(debug) << "open " << file.generic_string() << " as Bioptigen oct file";
 
@@ -461,7 +496,7 @@ namespace OctData
 
 
 
-		MainDict mainDict(series, op, callbackStepper);
+		MainDict mainDict(series, op, callbackStepper, filesize);
 
 		stream.seekg(0, std::ios_base::end);
 		std::size_t fielsize = stream.tellg();
@@ -469,6 +504,14 @@ namespace OctData
 
 		readDict(stream, mainDict, fielsize);
 
+		const int numBScans = static_cast<int>(series.bscanCount());
+		if(series.hasVolume() && numBScans < series.getVolume().size[0])
+		{
+			// less frames than in the header
+			const cv::Range ranges[] = { cv::Range(0, numBScans), cv::Range::all(), cv::Range::all() };
+			series.setVolume(numBScans > 0 ? series.getVolume()(ranges) : cv::Mat());
+		}
+
 		if(callback)
 			callback->callback(1); // set to 100% ( = 1 frac)
 
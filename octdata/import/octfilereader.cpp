@@ -1,6 +1,10 @@
 #include "octfilereader.h"
 
 #include "../octfileread.h"
+#include "../filereadoptions.h"
+
+#include <datastruct/oct.h>
+#include <datastruct/octmetadata.h>
 
 
 #include "he_vol/volread.h"
@@ -35,6 +39,48 @@ namespace OctData
 
 	}
 
+	bool OctFileReader::scanMetadata(FileReader& filereader, OctMetadata& metadata, const FileReadOptions& op) const
+	{
+		FileReadOptions headerOp = op;
+		headerOp.readBScans = false;
+		headerOp.readSlo    = false;
+		headerOp.lazyBScans = false;
+
+		OCT oct;
+		if(!readFile(filereader, oct, headerOp, nullptr))
+			return false;
+
+		// without the B-scans the readers don't know (or don't add) them
+		metadata = OctMetadata::fromOCT(oct, false);
+		return true;
+	}
+
+	void OctFileReader::addSignature(std::size_t offset, std::string bytes)
+	{
+		signatures.push_back(FileSignature{offset, std::move(bytes)});
+		signatureRequired = true;
+	}
+
+	void OctFileReader::addOptionalSignature(std::size_t offset, std::string bytes)
+	{
+		signatures.push_back(FileSignature{offset, std::move(bytes)});
+	}
+
+	OctFileReader::SignatureMatch OctFileReader::probeSignature(const std::string& prefix) const
+	{
+		if(signatures.empty())
+			return SignatureMatch::unknown;
+
+		for(const FileSignature& signature : signatures)
+		{
+			if(prefix.size() >= signature.offset + signature.bytes.size()
+			&& prefix.compare(signature.offset, signature.bytes.size(), signature.bytes) == 0)
+				return SignatureMatch::match;
+		}
+
+		return signatureRequired ? SignatureMatch::mismatch : SignatureMatch::unknown;
+	}
+
 	void OctFileReader::registerReaders(OctFileRead& fileRead)
 	{
 #ifdef HE_VOL_SUPPORT
@@ -2,6 +2,9 @@
 
 #include "../octextension.h"
 
+#include <string>
+#include <vector>
+
 namespace CppFW { class Callback; }
 
 namespace OctData
@@ -9,22 +12,56 @@ namespace OctData
 	class FileReadOptions;
 	class OctFileRead;
 	class OCT;
+	class OctMetadata;
 	class FileReader;
 
 	class OctFileReader
 	{
-		OctExtensionsList extList;
-
 	public:
+		enum class SignatureMatch { unknown, match, mismatch };
+
+		// bytes at offset from the (uncompressed) file start, which identify the format
+		struct FileSignature
+		{
+			std::size_t offset;
+			std::string bytes;
+		};
+
 		OctFileReader();
 		explicit OctFileReader(const OctExtension& ext);
 		explicit OctFileReader(const OctExtensionsList& ext);
 
 		virtual ~OctFileReader();
-		virtual bool readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* callback) = 0;
+
+		// one reader object is used by all threads, the state of a read file must be local to readFile
+		virtual bool readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* callback) const = 0;
+
+		/**
+		 * patient, study and series data without the images,
+		 * the default implementation calls readFile without B-scans and SLO, readers override it to read only the header
+		 */
+		virtual bool scanMetadata(FileReader& filereader, OctMetadata& metadata, const FileReadOptions& op) const;
+
 		const OctExtensionsList& getExtentsions() const { return extList; }
 
+		/**
+		 * cheap check of the file content, prefix is the start of the file (see OctFileRead::signaturePrefixSize)
+		 * unknown: the reader has no signature for the format, mismatch: readFile would reject the file
+		 */
+		virtual SignatureMatch probeSignature(const std::string& prefix) const;
+
 		static void registerReaders(OctFileRead& fileRead);
+
+	protected:
+		// files without one of the signatures are rejected by the reader
+		void addSignature        (std::size_t offset, std::string bytes);
+		// signature of some files of the format, files without it are still tried
+		void addOptionalSignature(std::size_t offset, std::string bytes);
+
+	private:
+		OctExtensionsList          extList;
+		std::vector<FileSignature> signatures;
+		bool                       signatureRequired = false;
 	};
 
 }
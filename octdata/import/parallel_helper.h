@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include<algorithm>
+#include<atomic>
+#include<condition_variable>
+#include<exception>
+#include<mutex>
+#include<thread>
+#include<vector>
+
+namespace OctData
+{
+	// number of threads for a thread option (values <= 0: number of cores), not more than jobs
+	inline std::size_t getNumWorkerThreads(int optionValue, std::size_t numJobs)
+	{
+		std::size_t numThreads = static_cast<std::size_t>(optionValue);
+		if(optionValue <= 0)
+			numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+		return std::max(std::min(numThreads, numJobs), static_cast<std::size_t>(1));
+	}
+
+	/**
+	 * calls job(index, worker) for every index in [0, numJobs) on numThreads threads (the calling thread is worker 0)
+	 * progress(numFinishedJobs) is only called from the calling thread, if it returns false no further jobs are started
+	 * an exception from a job or from progress stops the processing and is rethrown after all threads are joined
+	 * returns false if the processing was canceled by progress
+	 */
+	template<typename Job, typename Progress>
+	bool parallelFor(std::size_t numJobs, int numThreads, Job&& job, Progress&& progress)
+	{
+		std::atomic<std::size_t> nextJob     (0);
+		std::atomic<std::size_t> finishedJobs(0);
+		std::atomic<bool>        stop        (false);
+
+		std::mutex              mutex;
+		std::condition_variable finishedCondition;
+		std::exception_ptr      exception;
+
+		auto setException = [&](std::exception_ptr e)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if(!exception)
+				exception = e;
+			stop = true;
+		};
+
+		auto runJob = [&](std::size_t worker) -> bool
+		{
+			if(stop)
+				return false;
+			const std::size_t index = nextJob++;
+			if(index >= numJobs)
+				return false;
+
+			try
+			{
+				job(index, worker);
+			}
+			catch(...)
+			{
+				setException(std::current_exception());
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				++finishedJobs;
+			}
+			finishedCondition.notify_one();
+			return true;
+		};
+
+		const std::size_t numWorker = getNumWorkerThreads(numThreads, numJobs);
+		std::vector<std::thread> threads;
+		threads.reserve(numWorker - 1);
+		for(std::size_t worker = 1; worker < numWorker; ++worker)
+			threads.emplace_back([&runJob, worker]() { while(runJob(worker)); });
+
+		bool canceled = false;
+		try
+		{
+			std::size_t reported = 0;
+			while(reported < numJobs && !stop)
+			{
+				// work on the calling thread too, wait for the workers if there is nothing left
+				if(!runJob(0))
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					finishedCondition.wait(lock, [&]() { return finishedJobs != reported || stop; });
+				}
+
+				const std::size_t finished = finishedJobs;
+				if(finished != reported)
+				{
+					reported = finished;
+					if(!progress(reported))
+					{
+						canceled = true;
+						stop     = true;
+					}
+				}
+			}
+		}
+		catch(...)
+		{
+			setException(std::current_exception());
+		}
+
+		for(std::thread& t : threads)
+			t.join();
+
+		if(exception)
+			std::rethrow_exception(exception);
+
+		return !canceled;
+	}
+
+	template<typename Job>
+	void parallelFor(std::size_t numJobs, int numThreads, Job&& job)
+	{
+		parallelFor(numJobs, numThreads, std::forward<Job>(job), [](std::size_t) { return true; });
+	}
+}
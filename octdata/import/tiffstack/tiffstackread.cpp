@@ -3,6 +3,7 @@
 #include <datastruct/coordslo.h>
 #include <datastruct/sloimage.h>
 #include <datastruct/bscan.h>
+#include <datastruct/octmetadata.h>
 
 #include<filesystem>
 
@@ -28,13 +29,17 @@ namespace OctData
 	TiffStackRead::TiffStackRead()
 	: OctFileReader(OctExtension{".tiff", ".tif", "Tiff stack"})
 	{
+		addSignature(0, std::string("II*\0", 4));
+		addSignature(0, std::string("MM\0*", 4));
+		addSignature(0, std::string("II+\0", 4)); // BigTIFF
+		addSignature(0, std::string("MM\0+", 4));
 	}
 
-	bool TiffStackRead::readFile(FileReader& filereader, OCT& oct, const FileReadOptions& /*op*/, CppFW::Callback* /*callback*/)
+	bool TiffStackRead::readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* /*callback*/) const
 	{
 		const std::filesystem::path& file = filereader.getFilepath();
 
-		if(file.extension() != ".tiff" && file.extension() != ".tif")
+		if(!filereader.isSignatureMatch() && file.extension() != ".tiff" && file.extension() != ".tif")
 			return false;
 		
 		if(!bfs::exists(file))
@@ -56,7 +61,13 @@ namespace OctData
 			uint32 imageWidth, imageLength;
 // 			uint32 tileWidth, tileLength;
 
+			std::vector<std::shared_ptr<BScan>> bscans;
+
 			do {
+				++dircount;
+				if(!op.readBScans)
+					continue;
+
 				TIFFGetField(tif, TIFFTAG_IMAGEWIDTH , &imageWidth );
 				TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &imageLength);
 
@@ -68,11 +79,11 @@ namespace OctData
 				else
 					bscanImage = cv::Mat();
 
-				series.addBScan(std::make_shared<BScan>(bscanImage, bscanData));
-
-				++dircount;
+				bscans.push_back(std::make_shared<BScan>(bscanImage, bscanData));
 			} while(TIFFReadDirectory(tif));
 
+			series.addBScans(std::move(bscans));
+
 			TIFFClose(tif);
 		}
 
@@ -80,4 +91,35 @@ namespace OctData
 		return dircount>0;
 	}
 
+	bool TiffStackRead::scanMetadata(FileReader& filereader, OctMetadata& metadata, const FileReadOptions& /*op*/) const
+	{
+		const std::filesystem::path& file = filereader.getFilepath();
+
+		if(!filereader.isSignatureMatch() && file.extension() != ".tiff" && file.extension() != ".tif")
+			return false;
+
+		TIFF* tif = TIFFOpen(file.generic_string().c_str(), "r");
+		if(!tif)
+			return false;
+
+		uint32 imageWidth  = 0;
+		uint32 imageLength = 0;
+		TIFFGetField(tif, TIFFTAG_IMAGEWIDTH , &imageWidth );
+		TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &imageLength);
+
+		// TIFFNumberOfDirectories reads only the directory chain, not the image data
+		const std::size_t dircount = TIFFNumberOfDirectories(tif);
+		TIFFClose(tif);
+
+		Patient pat   (1);
+		Study   study (1);
+		Series  series(1);
+
+		SeriesMetadata& entry = metadata.addSeries(pat, study, series);
+		entry.numBScans   = dircount;
+		entry.bscanWidth  = static_cast<int>(imageWidth );
+		entry.bscanHeight = static_cast<int>(imageLength);
+		return true;
+	}
+
 }
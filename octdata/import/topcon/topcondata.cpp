@@ -116,11 +116,10 @@ void TopconData::transferData2Series()
 	applyParamScan(*this);
 	applyBscanCoords(*this);
 
+	std::vector<std::shared_ptr<OctData::BScan>> bscans;
+	bscans.reserve(bscanList.size());
 	for(BScanPair& pair : bscanList)
-	{
-		OctData::BScan::Data bscanData;
-		auto bscan = std::make_shared<OctData::BScan>(pair.image, pair.data);
+		bscans.push_back(std::make_shared<OctData::BScan>(pair.image, pair.data));
 
-		series.addBScan(std::move(bscan));
-	}
+	series.addBScans(std::move(bscans));
 }
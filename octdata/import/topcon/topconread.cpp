@@ -5,6 +5,7 @@
 #include<fstream>
 #include<iomanip>
 #include<array>
+#include<algorithm>
 #include<cmath>
 #include<filesystem>
 
@@ -22,9 +23,11 @@
 #include <datastruct/sloimage.h>
 #include <filereadoptions.h>
 #include<filereader/filereader.h>
+#include<filereader/filestreambuf.h>
 
 
 #include "../platform_helper.h"
+#include "../parallel_helper.h"
 #include "readjpeg2k.h"
 #include "topcondata.h"
 
@@ -74,21 +77,26 @@ namespace
 		return dest;
 	}
 
-	cv::Mat readAndEncodeJPEG2kData(std::istream& stream, uint32_t size)
+	// one ReadJPEG2K (OpenJPEG codec) per call, can be used from several threads
+	cv::Mat decodeJPEG2kData(const std::vector<char>& encodedData)
 	{
-		std::unique_ptr<char> encodedData(new char[size]);
-		stream.read(encodedData.get(), size);
-
 		cv::Mat image;
 		ReadJPEG2K reader;
-		reader.openJpeg(encodedData.get(), size);
+		reader.openJpeg(encodedData.data(), encodedData.size());
 		reader.getImage(image, false);
 
 		return image;
 	}
 
+	cv::Mat readAndEncodeJPEG2kData(std::istream& stream, uint32_t size)
+	{
+		std::vector<char> encodedData(size);
+		stream.read(encodedData.data(), size);
+		return decodeJPEG2kData(encodedData);
+	}
 
-	void readImgJpeg(std::istream& stream, TopconData& data, CppFW::Callback* callback, const OctData::FileReadOptions& op)
+
+	void readImgJpeg(std::istream& stream, TopconData& data, CppFW::Callback* callback, const OctData::FileReadOptions& op, uint32_t chunkSize)
 	{
 		if(!op.readBScans)
 			return;
@@ -134,24 +142,56 @@ namespace
 // 				break;
 		}
 
+		// read the compressed frames, the decoding is done in parallel
+		// frames and frame sizes are not trusted, every frame needs at least its size field in the chunk
+		constexpr std::size_t headerSize = sizeof(uint8_t) + 6*sizeof(uint32_t);
+		std::size_t chunkRemaining = chunkSize > headerSize ? chunkSize - headerSize : 0;
+
+		std::vector<std::vector<char>> encodedFrames;
+		encodedFrames.reserve(std::min(static_cast<std::size_t>(frames), chunkRemaining/sizeof(uint32_t)));
 		for(uint32_t frame = 0; frame < frames; ++frame)
 		{
-			if(callback)
+			if(chunkRemaining < sizeof(uint32_t))
+				break;
+			const uint32_t size = readFStream<uint32_t>(stream);
+			chunkRemaining -= sizeof(uint32_t);
+			if(size > chunkRemaining)
 			{
-				if(!callback->callback(static_cast<double>(frame)/static_cast<double>(frames)))
-					break;
+				BOOST_LOG_TRIVIAL(warning) << "Topcon: frame " << frame << " exceeds the @IMG_JPEG chunk, stop reading frames";
+				break;
 			}
+			chunkRemaining -= size;
+			std::vector<char> encodedData(size);
+			stream.read(encodedData.data(), size);
+			if(!stream.good())
+				break;
+			encodedFrames.push_back(std::move(encodedData));
+		}
 
-			const uint32_t size = readFStream<uint32_t>(stream);
-			cv::Mat image = readAndEncodeJPEG2kData(stream, size);
-
-			image.convertTo(image, cv::DataType<uint8_t>::type, 2, -128);
+		std::vector<cv::Mat> images (encodedFrames.size());
+		std::vector<uint8_t> decoded(encodedFrames.size(), 0);
 
+		auto decodeJob = [&](std::size_t frame, std::size_t)
+			{
+				cv::Mat image = decodeJPEG2kData(encodedFrames[frame]);
+				image.convertTo(images[frame], cv::DataType<uint8_t>::type, 2, -128);
+				decoded[frame] = 1;
+			};
+		auto progress  = [&](std::size_t finished)
+			{
+				if(callback)
+					return callback->callback(static_cast<double>(finished)/static_cast<double>(encodedFrames.size()));
+				return true;
+			};
+		OctData::parallelFor(encodedFrames.size(), op.numThreads, decodeJob, progress);
+
+		// frames in file order, up to the first not decoded frame if canceled
+		for(std::size_t frame = 0; frame < images.size() && decoded[frame]; ++frame)
+		{
 			TopconData::BScanPair pair;
-			pair.image = image;
+			pair.image = images[frame];
 			pair.data.bscanType = bscanType;
 			data.bscanList.push_back(pair);
-
 		}
 	}
 
@@ -355,7 +395,7 @@ namespace
 			}
 		};
 
-		static ConturInfo conturInfo;
+		static const ConturInfo conturInfo;
 
 		if(!op.readBScans)
 			return;
@@ -483,9 +523,10 @@ namespace OctData
 	TopconFileFormatRead::TopconFileFormatRead()
 	: OctFileReader(OctExtension(".fda", "Topcon"))
 	{
+		addSignature(0, "FOCT");
 	}
 
-	bool TopconFileFormatRead::readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* callback)
+	bool TopconFileFormatRead::readFile(FileReader& filereader, OCT& oct, const FileReadOptions& op, CppFW::Callback* callback) const
 	{
 		const std::filesystem::path& file = filereader.getFilepath();
 //
@@ -496,18 +537,19 @@ namespace OctData
 //     BOOST_LOG_TRIVIAL(error) << "An error severity message";
 //     BOOST_LOG_TRIVIAL(fatal) << "A fatal severity message";
 
-		if(file.extension() != ".fda")
+		if(!filereader.isSignatureMatch() && file.extension() != ".fda")
 			return false;
 
 		BOOST_LOG_TRIVIAL(trace) << "Try to open OCT file as topcon file";
 
 
-		std::fstream stream(file, std::ios::binary | std::ios::in);
-		if(!stream.good())
+		if(!filereader.openFile())
 		{
 			BOOST_LOG_TRIVIAL(error) << "Can't open topcon file " << file;
 			return false;
 		}
+		FileStreamBuf streamBuf(filereader, static_cast<std::size_t>(std::max(op.readBufferSize, 0)));
+		std::istream stream(&streamBuf);
 
 		BOOST_LOG_TRIVIAL(debug) << "open " << file.generic_string() << " as topcon file";
 
@@ -558,7 +600,7 @@ namespace OctData
 			if(chunkName == "@IMG_TRC_02")
 				readImgSlo(stream, data, SLOType::TRC);
 			else if(chunkName == "@IMG_JPEG")
-				readImgJpeg(stream, data, callback, op);
+				readImgJpeg(stream, data, callback, op, chunkSize);
 			else if(chunkName == "@PATIENT_INFO_02")
 				readPatientInfo0203(stream, data, op, false);
 			else if(chunkName == "@PATIENT_INFO_03")
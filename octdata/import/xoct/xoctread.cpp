@@ -2,6 +2,7 @@
 
 #include<locale>
 #include<vector>
+#include<algorithm>
 #include<sstream>
 #include <thread>
 #include <chrono>
@@ -30,6 +31,10 @@
 #include <octfileread.h>
 #include<filereader/filereader.h>
 
+#include <export/xoct/xoctsegmentationbin.h>
+
+#include "../parallel_helper.h"
+
 namespace bfs = std::filesystem;
 namespace bpt = boost::property_tree;
 namespace bip = boost::interprocess;
@@ -164,7 +169,8 @@ namespace OctData
 			}
 		}
 
-		std::shared_ptr<BScan> readBScan(const bpt::ptree& bscanNode, CppFW::UnzipCpp& zipfile)
+		// binarySegmentation: segmentation from the binary entry of the series, nullptr: segmentation xml of the B-scan
+		std::shared_ptr<BScan> readBScan(const bpt::ptree& bscanNode, CppFW::UnzipCpp& zipfile, const Segmentationlines* binarySegmentation)
 		{
 			cv::Mat bscanImg = readImage(bscanNode, zipfile, "image");
 			if(bscanImg.empty())
@@ -173,7 +179,9 @@ namespace OctData
 			cv::Mat imageAngio = readImage(bscanNode, zipfile, "angioImage");
 
 			BScan::Data bscanData;
-			try// seglines
+			if(binarySegmentation)
+				bscanData.segmentationslines = *binarySegmentation;
+			else try// seglines
 			{
 				std::string layerSegmentationPath = bscanNode.get<std::string>("LayerSegmentationFile");
 				bpt::ptree xmlTree = readXml(zipfile, layerSegmentationPath);
@@ -191,24 +199,71 @@ namespace OctData
 			return bscan;
 		}
 
-		bool readBScanList(const bpt::ptree seriesNode, CppFW::UnzipCpp& zipfile, Series& series, CppFW::Callback* callback)
+		// the opened xoct file, the filename is used to open more handles (UnzipCpp is not thread safe)
+		struct XOctArchive
 		{
-			const std::size_t numBScan = seriesNode.count("BScan");
-			CppFW::CallbackStepper bscanCallbackStepper(callback, numBScan);
+			CppFW::UnzipCpp& zipfile;
+			std::string      filename;
+		};
 
-			for(const std::pair<const std::string, bpt::ptree>& subTreePair : seriesNode)
+		// segmentation of all B-scans of the series (xoct files without binary segmentation entry: empty)
+		std::vector<Segmentationlines> readSegmentationBin(const bpt::ptree& seriesNode, CppFW::UnzipCpp& zipfile)
+		{
+			std::vector<Segmentationlines> bscanSegmentations;
+
+			const boost::optional<std::string> segmentationFile = seriesNode.get_optional<std::string>("LayerSegmentationBinFile");
+			if(segmentationFile)
 			{
-// 				std::this_thread::sleep_for(std::chrono::milliseconds(50));
-				if(subTreePair.first != "BScan")
-					continue;
+				if(!XOctSegmentationBin::read(zipfile.readFile(*segmentationFile), bscanSegmentations))
+					BOOST_LOG_TRIVIAL(error) << "xoct: broken or unsupported segmentation entry " << *segmentationFile;
+			}
+			return bscanSegmentations;
+		}
 
-				if(++bscanCallbackStepper == false)
-					return false;
+		/**
+		 * the B-scans are read and decoded (images and segmentation xml) in parallel,
+		 * every worker has its own unzip handle, worker 0 (calling thread) uses the open archive
+		 */
+		bool readBScanList(const bpt::ptree& seriesNode, XOctArchive& archive, Series& series, const OctData::FileReadOptions& op, CppFW::Callback* callback)
+		{
+			const std::vector<Segmentationlines> bscanSegmentations = readSegmentationBin(seriesNode, archive.zipfile);
+			const bool binarySegmentation = seriesNode.count("LayerSegmentationBinFile") > 0;
+			const Segmentationlines emptySegmentation;
 
-				std::shared_ptr<BScan> bscan = readBScan(subTreePair.second, zipfile);
-				if(bscan)
-					series.addBScan(std::move(bscan));
-			}
+			std::vector<const bpt::ptree*> bscanNodes;
+			for(const std::pair<const std::string, bpt::ptree>& subTreePair : seriesNode)
+				if(subTreePair.first == "BScan")
+					bscanNodes.push_back(&subTreePair.second);
+
+			const std::size_t numBScan = bscanNodes.size();
+			std::vector<std::shared_ptr<BScan>> bscans(numBScan);
+			std::vector<std::unique_ptr<CppFW::UnzipCpp>> workerZipfiles(getNumWorkerThreads(op.numThreads, numBScan));
+
+			auto readJob = [&](std::size_t index, std::size_t worker)
+				{
+					CppFW::UnzipCpp* zipfile = &archive.zipfile;
+					if(worker > 0)
+					{
+						if(!workerZipfiles[worker])
+							workerZipfiles[worker] = std::make_unique<CppFW::UnzipCpp>(archive.filename);
+						zipfile = workerZipfiles[worker].get();
+					}
+					const Segmentationlines* segmentation = nullptr;
+					if(binarySegmentation)
+						segmentation = index < bscanSegmentations.size() ? &bscanSegmentations[index] : &emptySegmentation;
+					bscans[index] = readBScan(*bscanNodes[index], *zipfile, segmentation);
+				};
+			auto progress = [&](std::size_t finished)
+				{
+					if(callback)
+						return callback->callback(static_cast<double>(finished)/static_cast<double>(numBScan));
+					return true;
+				};
+			if(!parallelFor(numBScan, op.numThreads, readJob, progress))
+				return false;
+
+			bscans.erase(std::remove(bscans.begin(), bscans.end(), nullptr), bscans.end());
+			series.addBScans(std::move(bscans));
 			return true;
 		}
 
@@ -225,7 +280,7 @@ namespace OctData
 
 
 		template<typename S>
-		bool readStructure(const bpt::ptree& tree, CppFW::UnzipCpp& zipfile, S& structure, const OctData::FileReadOptions& op, CppFW::Callback* callback)
+		bool readStructure(const bpt::ptree& tree, XOctArchive& archive, S& structure, const OctData::FileReadOptions& op, CppFW::Callback* callback)
 		{
 			static const std::string subStructureName = getSubStructureName<S>();
 
@@ -247,31 +302,31 @@ namespace OctData
 				boost::optional<std::string> filenameSub(subTreeNode.get_optional<std::string>("filename"));
 				if(filenameSub)
 				{
-					bpt::ptree subFileTree = readXml(zipfile, *filenameSub);
+					bpt::ptree subFileTree = readXml(archive.zipfile, *filenameSub);
 					boost::optional<bpt::ptree&> subFileTreeNode = subFileTree.get_child_optional(subStructureName);
 					if(subFileTreeNode)
-						result &= readStructure(*subFileTreeNode, zipfile, structure.getInsertId(id), op, &subCallback);
+						result &= readStructure(*subFileTreeNode, archive, structure.getInsertId(id), op, &subCallback);
 					else
 						result = false;
 				}
 				else
-					result &= readStructure(subTreeNode, zipfile, structure.getInsertId(id), op, &subCallback);
+					result &= readStructure(subTreeNode, archive, structure.getInsertId(id), op, &subCallback);
 			}
 			return result;
 		}
 
 
 		template<>
-		bool readStructure<Series>(const bpt::ptree& tree, CppFW::UnzipCpp& zipfile, Series& series, const OctData::FileReadOptions& op, CppFW::Callback* callback)
+		bool readStructure<Series>(const bpt::ptree& tree, XOctArchive& archive, Series& series, const OctData::FileReadOptions& op, CppFW::Callback* callback)
 		{
 			readDataNode(tree, series);
 
 			boost::optional<const bpt::ptree&> sloNode = tree.get_child_optional("slo");
-			if(sloNode)
-				series.takeSloImage(readSlo(*sloNode, zipfile));
+			if(sloNode && op.readSlo)
+				series.takeSloImage(readSlo(*sloNode, archive.zipfile));
 
 			if(op.readBScans)
-				return readBScanList(tree, zipfile, series, callback);
+				return readBScanList(tree, archive, series, op, callback);
 			else
 				return true;
 		}
@@ -280,12 +335,13 @@ namespace OctData
 	XOctRead::XOctRead()
 	: OctFileReader(OctExtension(".xoct", "XOct format"))
 	{
+		addSignature(0, std::string("PK\x03\x04", 4)); // zip local file header
 	}
 
-	bool OctData::XOctRead::readFile(OctData::FileReader& filereader, OctData::OCT& oct, const OctData::FileReadOptions& op, CppFW::Callback* callback)
+	bool OctData::XOctRead::readFile(OctData::FileReader& filereader, OctData::OCT& oct, const OctData::FileReadOptions& op, CppFW::Callback* callback) const
 	{
 		const std::filesystem::path file = filereader.getFilepath();
-		if(file.extension() != ".xoct")
+		if(!filereader.isSignatureMatch() && file.extension() != ".xoct")
 			return false;
 
 		BOOST_LOG_TRIVIAL(trace) << "Try to open OCT file as xoct";
@@ -299,8 +355,9 @@ namespace OctData
 
 		boost::optional<bpt::ptree&> xoctTree = xmlTree.get_child_optional("XOCT");
 
+		XOctArchive archive{zipfile, file.generic_string()};
 		if(xoctTree)
-			return readStructure(*xoctTree, zipfile, oct, op, callback);
+			return readStructure(*xoctTree, archive, oct, op, callback);
 		else
 		{
 			BOOST_LOG_TRIVIAL(error) << "XOCT node in xml not found";
@@ -20,9 +20,11 @@
 #include<filesystem>
 
 #include <datastruct/oct.h>
+#include <datastruct/octmetadata.h>
 #include "import/octfilereader.h"
 #include "filereadoptions.h"
 #include "filewriteoptions.h"
+#include "threadpool.h"
 
 
 #include<opencv2/opencv.hpp>
@@ -80,6 +82,24 @@ namespace OctData
 
 
 
+	std::vector<std::future<OCT>> OctFileRead::openFiles(const std::vector<sfs::path>& files, const FileReadOptions& op, ThreadPool& executor)
+	{
+		const std::shared_ptr<const FileReadOptions> sharedOp = std::make_shared<const FileReadOptions>(op);
+		OctFileRead& instance = getInstance(); // construct the readers before the workers use them
+
+		std::vector<std::future<OCT>> results;
+		results.reserve(files.size());
+		for(const sfs::path& file : files)
+			results.push_back(executor.submit([&instance, sharedOp, file]() { return instance.openFilePrivat(file, *sharedOp, nullptr); }));
+		return results;
+	}
+
+	std::vector<std::future<OCT>> OctFileRead::openFiles(const std::vector<sfs::path>& files, const FileReadOptions& op)
+	{
+		return openFiles(files, op, ThreadPool::getShared());
+	}
+
+
 	OCT OctFileRead::openFilePrivat(const std::string& filename, const FileReadOptions& op, CppFW::Callback* callback)
 	{
 		sfs::path file(filename);
@@ -88,26 +108,56 @@ namespace OctData
 
 
 
-	bool OctFileRead::openFileFromExt(OCT& oct, FileReader& filereader, const FileReadOptions& op, CppFW::Callback* callback)
+	/**
+	 * readers in the order they are tried for the file:
+	 * first the readers whose signature is found in the file start, then the readers for the file extension
+	 * and then the remaining readers, readers with a mismatching signature are skipped
+	 * so files with a wrong or missing extension are opened without trying every reader
+	 */
+	std::vector<OctFileRead::ReaderCandidate> OctFileRead::getReaderCandidates(FileReader& filereader) const
 	{
-		std::string filename = filereader.getFilepath().generic_string();
+		const std::string prefix   = filereader.readPrefix(signaturePrefixSize);
+		const std::string filename = filereader.getFilepath().generic_string();
+
+		std::vector<ReaderCandidate> signatureReaders;
+		std::vector<ReaderCandidate> extensionReaders;
+		std::vector<ReaderCandidate> otherReaders;
+
 		for(OctFileReader* reader : fileReaders)
 		{
-			if(reader->getExtentsions().matchWithFile(filename))
+			// empty prefix: file can't be read here, let the readers decide
+			const OctFileReader::SignatureMatch signature = prefix.empty() ? OctFileReader::SignatureMatch::unknown : reader->probeSignature(prefix);
+
+			switch(signature)
 			{
-				if(reader->readFile(filereader, oct, op, callback))
-					return true;
-				oct.clear();
+				case OctFileReader::SignatureMatch::match:
+					signatureReaders.push_back(ReaderCandidate{reader, true});
+					break;
+				case OctFileReader::SignatureMatch::unknown:
+					if(reader->getExtentsions().matchWithFile(filename))
+						extensionReaders.push_back(ReaderCandidate{reader, false});
+					else
+						otherReaders.push_back(ReaderCandidate{reader, false});
+					break;
+				case OctFileReader::SignatureMatch::mismatch: // readFile would reject the file
+					break;
 			}
 		}
-		return false;
+
+		signatureReaders.insert(signatureReaders.end(), extensionReaders.begin(), extensionReaders.end());
+		signatureReaders.insert(signatureReaders.end(), otherReaders    .begin(), otherReaders    .end());
+		return signatureReaders;
 	}
 
 	bool OctFileRead::tryOpenFile(OCT& oct, FileReader& filereader, const FileReadOptions& op, CppFW::Callback* callback)
 	{
-		for(OctFileReader* reader : fileReaders)
+		for(const ReaderCandidate& candidate : getReaderCandidates(filereader))
 		{
-			if(reader->readFile(filereader, oct, op, callback))
+			filereader.setSignatureMatch(candidate.signatureMatch);
+			const bool result = candidate.reader->readFile(filereader, oct, op, callback);
+			filereader.setSignatureMatch(false);
+
+			if(result)
 				return true;
 			oct.clear();
 		}
@@ -121,8 +171,7 @@ namespace OctData
 
 		if(sfs::exists(file))
 		{
-			if(!openFileFromExt(oct, filereader, op, callback))
-				tryOpenFile(oct, filereader, op, callback);
+			tryOpenFile(oct, filereader, op, callback);
 		}
 		else
 			BOOST_LOG_TRIVIAL(error) << "file " << file.generic_string() << " not exists";
@@ -130,6 +179,40 @@ namespace OctData
 		return oct;
 	}
 
+	OctMetadata OctFileRead::scanMetadata(const std::filesystem::path& filename, const FileReadOptions& op)
+	{
+		return getInstance().scanMetadataPrivat(filename, op);
+	}
+
+	OctMetadata OctFileRead::scanMetadata(const std::filesystem::path& filename)
+	{
+		return getInstance().scanMetadataPrivat(filename, FileReadOptions());
+	}
+
+	OctMetadata OctFileRead::scanMetadataPrivat(const std::filesystem::path& file, const FileReadOptions& op)
+	{
+		FileReader filereader(file);
+		OctMetadata metadata;
+
+		if(!sfs::exists(file))
+		{
+			BOOST_LOG_TRIVIAL(error) << "file " << file.generic_string() << " not exists";
+			return metadata;
+		}
+
+		for(const ReaderCandidate& candidate : getReaderCandidates(filereader))
+		{
+			filereader.setSignatureMatch(candidate.signatureMatch);
+			const bool result = candidate.reader->scanMetadata(filereader, metadata, op);
+			filereader.setSignatureMatch(false);
+
+			if(result)
+				break;
+			metadata = OctMetadata();
+		}
+		return metadata;
+	}
+
 // used by friend class OctFileReader
 	void OctFileRead::registerFileRead(OctFileReader* reader)
 	{
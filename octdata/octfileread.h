@@ -19,6 +19,7 @@
 
 #include <vector>
 #include <string>
+#include <future>
 #include <filesystem>
 
 #include "octextension.h"
@@ -34,12 +35,18 @@ namespace CppFW { class Callback; }
 namespace OctData
 {
 	class OCT;
+	class OctMetadata;
 	class OctFileReader;
 	class FileReadOptions;
 	class FileWriteOptions;
 	class OctExtensionsList;
 	class FileReader;
+	class ThreadPool;
 
+	/**
+	 * all functions can be called from several threads at the same time:
+	 * the registered readers are created once and hold no state of a read file (OctFileReader::readFile is const)
+	 */
 	class OctFileRead
 	{
 		friend class OctFileReader;
@@ -53,6 +60,19 @@ namespace OctData
 
 		Octdata_EXPORTS static bool isLoadable(const std::string& filename);
 
+		// opens the files concurrently on executor (default: ThreadPool::getShared()), the futures are in the order of files
+		// a future throws the exception of a failed open, a not loadable file gives an empty OCT
+		// op.numThreads = 1 avoids that every file starts its own conversion threads
+		Octdata_EXPORTS static std::vector<std::future<OCT>> openFiles(const std::vector<std::filesystem::path>& files, const FileReadOptions& op, ThreadPool& executor);
+		Octdata_EXPORTS static std::vector<std::future<OCT>> openFiles(const std::vector<std::filesystem::path>& files, const FileReadOptions& op);
+
+		// patient, study and series data of the file without loading images (for indexing large archives)
+		Octdata_EXPORTS static OctMetadata scanMetadata(const std::filesystem::path& filename, const FileReadOptions& op);
+		Octdata_EXPORTS static OctMetadata scanMetadata(const std::filesystem::path& filename);
+
+		// number of bytes from the file start, which are passed to OctFileReader::probeSignature
+		constexpr static const std::size_t signaturePrefixSize = 512;
+
 		Octdata_EXPORTS static bool writeFile(const std::string& filename, const OCT& octdata);
 		Octdata_EXPORTS static bool writeFile(const std::string& filename, const OCT& octdata, const FileWriteOptions& opt);
 		Octdata_EXPORTS static bool writeFile(const std::filesystem::path& filepath, const OCT& octdata, const FileWriteOptions& opt);
@@ -64,11 +84,18 @@ namespace OctData
 		void registerFileRead(OctFileReader* reader);
 		OCT openFilePrivat(const std::string& filename, const FileReadOptions& op, CppFW::Callback* callback);
 		OCT openFilePrivat(const std::filesystem::path& file, const FileReadOptions& op, CppFW::Callback* callback);
+		OctMetadata scanMetadataPrivat(const std::filesystem::path& file, const FileReadOptions& op);
 
 		bool writeFilePrivat(const std::filesystem::path& filepath, const OCT& octdata, const FileWriteOptions& opt);
 
-		bool openFileFromExt(OCT& oct, FileReader& filename, const FileReadOptions& op, CppFW::Callback* callback);
-		bool tryOpenFile(OCT& oct, FileReader& filename, const FileReadOptions& op, CppFW::Callback* callback);
+		struct ReaderCandidate
+		{
+			OctFileReader* reader;
+			bool           signatureMatch;
+		};
+
+		std::vector<ReaderCandidate> getReaderCandidates(FileReader& filereader) const;
+		bool tryOpenFile(OCT& oct, FileReader& filereader, const FileReadOptions& op, CppFW::Callback* callback);
 
 		OctExtensionsList extensions;
 
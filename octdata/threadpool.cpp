@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "threadpool.h"
+
+#include <limits>
+
+#include <boost/log/trivial.hpp>
+
+#include "import/parallel_helper.h"
+
+namespace OctData
+{
+	namespace
+	{
+		// worker of the pool on this thread (posts from a worker go to its own queue)
+		struct CurrentWorker
+		{
+			const ThreadPool* pool   = nullptr;
+			std::size_t       worker = 0;
+		};
+
+		thread_local CurrentWorker currentWorker;
+	}
+
+	ThreadPool::ThreadPool(int numThreads)
+	: nextQueue(0)
+	{
+		const std::size_t numWorker = getNumWorkerThreads(numThreads, std::numeric_limits<std::size_t>::max());
+
+		queues.reserve(numWorker);
+		for(std::size_t worker = 0; worker < numWorker; ++worker)
+			queues.push_back(std::make_unique<WorkerQueue>());
+
+		workers.reserve(numWorker);
+		for(std::size_t worker = 0; worker < numWorker; ++worker)
+			workers.emplace_back([this, worker]() { workerLoop(worker); });
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(waitMutex);
+			stop = true;
+		}
+		waitCondition.notify_all();
+
+		for(std::thread& t : workers)
+			t.join();
+	}
+
+	ThreadPool& ThreadPool::getShared()
+	{
+		static ThreadPool pool;
+		return pool;
+	}
+
+	void ThreadPool::post(Task task)
+	{
+		const std::size_t queueIndex = currentWorker.pool == this ? currentWorker.worker : nextQueue++ % queues.size();
+
+		{
+			WorkerQueue& queue = *queues[queueIndex];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.tasks.push_back(std::move(task));
+		}
+
+		// the task is in a queue before it is counted, so a worker which has taken a count finds a task
+		{
+			std::lock_guard<std::mutex> lock(waitMutex);
+			++pendingTasks;
+		}
+		waitCondition.notify_one();
+	}
+
+	bool ThreadPool::popTask(std::size_t worker, Task& task)
+	{
+		{
+			WorkerQueue& own = *queues[worker];
+			std::lock_guard<std::mutex> lock(own.mutex);
+			if(!own.tasks.empty())
+			{
+				task = std::move(own.tasks.back());
+				own.tasks.pop_back();
+				return true;
+			}
+		}
+
+		for(std::size_t i = 1; i < queues.size(); ++i)
+		{
+			WorkerQueue& other = *queues[(worker + i) % queues.size()];
+			std::lock_guard<std::mutex> lock(other.mutex);
+			if(!other.tasks.empty())
+			{
+				task = std::move(other.tasks.front());
+				other.tasks.pop_front();
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void ThreadPool::workerLoop(std::size_t worker)
+	{
+		currentWorker.pool   = this;
+		currentWorker.worker = worker;
+
+		for(;;)
+		{
+			{
+				std::unique_lock<std::mutex> lock(waitMutex);
+				waitCondition.wait(lock, [this]() { return pendingTasks > 0 || stop; });
+				if(pendingTasks == 0) // stop and all tasks done
+					break;
+				--pendingTasks;
+			}
+
+			// a counted task is in one of the queues, an other worker can take it before, but then its own task is left
+			Task task;
+			while(!popTask(worker, task))
+				std::this_thread::yield();
+
+			try
+			{
+				task();
+			}
+			catch(const std::exception& e)
+			{
+				BOOST_LOG_TRIVIAL(error) << "ThreadPool: exception in task: " << e.what();
+			}
+			catch(...)
+			{
+				BOOST_LOG_TRIVIAL(error) << "ThreadPool: unknown exception in task";
+			}
+		}
+
+		currentWorker = CurrentWorker();
+	}
+}
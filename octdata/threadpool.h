@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef OCTDATA_EXPORT
+	#include "octdata_EXPORTS.h"
+#else
+	#define Octdata_EXPORTS
+#endif
+
+namespace OctData
+{
+	/**
+	 * thread pool with a fixed number of workers and one task queue per worker
+	 * a worker takes the newest task from its own queue, an idle worker steals the oldest task from the other queues
+	 * tasks posted from a worker thread are put in the queue of this worker, other tasks are distributed round robin
+	 * the destructor runs all queued tasks and joins the workers
+	 */
+	class ThreadPool
+	{
+	public:
+		typedef std::function<void()> Task;
+
+		Octdata_EXPORTS explicit ThreadPool(int numThreads = 0); // numThreads <= 0: number of cores
+		Octdata_EXPORTS ~ThreadPool();
+
+		ThreadPool(const ThreadPool&)            = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		Octdata_EXPORTS std::size_t getNumThreads()              const { return workers.size(); }
+
+		// exceptions from task are logged and dropped, use submit to get them
+		Octdata_EXPORTS void post(Task task);
+
+		template<typename F>
+		auto submit(F&& f) -> std::future<decltype(f())>
+		{
+			typedef decltype(f()) Result;
+			std::shared_ptr<std::packaged_task<Result()>> task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(f));
+			std::future<Result> future = task->get_future();
+			post([task]() { (*task)(); });
+			return future;
+		}
+
+		// pool used by the library functions without an explicit executor (OctFileRead::openFiles)
+		Octdata_EXPORTS static ThreadPool& getShared();
+
+	private:
+		struct WorkerQueue
+		{
+			std::mutex       mutex;
+			std::deque<Task> tasks;
+		};
+
+		bool popTask(std::size_t worker, Task& task);
+		void workerLoop(std::size_t worker);
+
+		std::vector<std::unique_ptr<WorkerQueue>> queues;
+		std::vector<std::thread>                  workers;
+		std::atomic<std::size_t>                  nextQueue;
+
+		std::mutex              waitMutex;
+		std::condition_variable waitCondition;
+		std::size_t             pendingTasks = 0;     // queued and not taken by a worker, guarded by waitMutex
+		bool                    stop         = false; // guarded by waitMutex
+	};
+}
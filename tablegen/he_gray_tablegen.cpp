@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * he_gray_tablegen: writes the gray transform tables of the E2E import as static arrays,
+ * the values come from the functions in import/he_e2e/he_gray_transform.cpp (build step, see CMakeLists.txt)
+ */
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+#include <import/he_e2e/he_gray_transform.h>
+
+namespace
+{
+	typedef uint8_t (*ValueFunction)(uint16_t);
+
+	void writeTable(std::ostream& stream, const char* name, ValueFunction valueFunction)
+	{
+		stream << "\tconst uint8_t " << name << "[lut16To8TableSize] =\n\t{";
+		for(int i = 0; i <= std::numeric_limits<uint16_t>::max(); ++i)
+		{
+			if(i % 32 == 0)
+				stream << "\n\t\t";
+			stream << static_cast<int>(valueFunction(static_cast<uint16_t>(i))) << ',';
+		}
+		stream << "\n\t}; // padding entries are 0\n\n";
+	}
+}
+
+
+int main(int argc, char** argv)
+{
+	if(argc != 2)
+	{
+		std::cerr << "usage: " << argv[0] << " <output.cpp>\n";
+		return 1;
+	}
+
+	std::ofstream stream(argv[1]);
+	stream << "// generated by he_gray_tablegen, do not edit\n\n"
+	          "#include <import/he_e2e/he_gray_transform.h>\n"
+	          "#include <imgproc/lut16to8.h>\n\n"
+	          "namespace OctData\n{\n";
+
+	writeTable(stream, "heGrayTransformXmlLUT"     , &OctData::HeGrayTransformXml     ::getXmlValue  );
+	writeTable(stream, "heGrayTransformVolLUT"     , &OctData::HeGrayTransformVol     ::getVolValue  );
+	writeTable(stream, "heGrayTransformUFloat16LUT", &OctData::HeGrayTransformUFloat16::getUint8Value);
+	writeTable(stream, "heGrayTransformNativLUT"   , &OctData::HeGrayTransformNativ   ::getNativValue);
+
+	stream << "}\n";
+
+	stream.close();
+	if(!stream)
+	{
+		std::cerr << "can't write " << argv[1] << '\n';
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2018 Kay Gawlik <kaydev@amarunet.de> <kay.gawlik@beuth-hochschule.de> <kay.gawlik@charite.de>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * he_gray_tables_test: compares the generated gray transform tables with the value functions
+ * and checks that the padding entries behind the 2^16 values are 0 (ctest, see CMakeLists.txt)
+ */
+
+#include <cstdint>
+#include <iostream>
+#include <limits>
+
+#include <import/he_e2e/he_gray_transform.h>
+#include <imgproc/lut16to8.h>
+
+namespace
+{
+	typedef uint8_t (*ValueFunction)(uint16_t);
+
+	int checkTable(const char* name, const uint8_t* lut, ValueFunction valueFunction)
+	{
+		int errors = 0;
+		for(int i = 0; i <= std::numeric_limits<uint16_t>::max(); ++i)
+		{
+			const uint8_t expected = valueFunction(static_cast<uint16_t>(i));
+			if(lut[i] != expected)
+			{
+				if(errors < 10)
+					std::cerr << name << '[' << i << "] = " << static_cast<int>(lut[i]) << ", expected " << static_cast<int>(expected) << '\n';
+				++errors;
+			}
+		}
+
+		for(std::size_t i = std::numeric_limits<uint16_t>::max() + 1u; i < OctData::lut16To8TableSize; ++i)
+		{
+			if(lut[i] != 0)
+			{
+				std::cerr << name << '[' << i << "] = " << static_cast<int>(lut[i]) << ", padding expected 0\n";
+				++errors;
+			}
+		}
+		return errors;
+	}
+}
+
+
+int main()
+{
+	int errors = 0;
+	errors += checkTable("heGrayTransformXmlLUT"     , OctData::heGrayTransformXmlLUT     , &OctData::HeGrayTransformXml     ::getXmlValue  );
+	errors += checkTable("heGrayTransformVolLUT"     , OctData::heGrayTransformVolLUT     , &OctData::HeGrayTransformVol     ::getVolValue  );
+	errors += checkTable("heGrayTransformUFloat16LUT", OctData::heGrayTransformUFloat16LUT, &OctData::HeGrayTransformUFloat16::getUint8Value);
+	errors += checkTable("heGrayTransformNativLUT"   , OctData::heGrayTransformNativLUT   , &OctData::HeGrayTransformNativ   ::getNativValue);
+
+	if(errors > 0)
+	{
+		std::cerr << errors << " wrong table entries\n";
+		return 1;
+	}
+	return 0;
+}